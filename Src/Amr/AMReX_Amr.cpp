@@ -331,6 +331,9 @@ Amr::InitAmr ()
     level_count.resize(nlev);
     n_cycle.resize(nlev);
     dt_min.resize(nlev);
+    advance_time.resize(nlev, 0.0);
+    advance_cells.resize(nlev, 0.0);
+    cost_per_cell.resize(nlev, 0.0);
     amr_level.resize(nlev);
     //
     // Set bogus values.
@@ -1932,8 +1935,16 @@ Amr::timeStep (int  level,
     which_level_being_advanced = level;
 
 
-    // Update so that by default, we don't force a post-step regrid.
-    amr_level[level]->setPostStepRegrid(0);
+    // Update so that by default, we don't force a post-step regrid.  In
+    // Synchronous mode, timeStep is not called on the finer levels, so
+    // their flags are reset here too.
+    if (level == 0 && subcycling_mode == "Synchronous") {
+        for (int lev = 0; lev <= finest_level; ++lev) {
+            amr_level[lev]->setPostStepRegrid(0);
+        }
+    } else {
+        amr_level[level]->setPostStepRegrid(0);
+    }
 
     if(max_level==0 && force_regrid_level_zero){
         regrid_level_0_on_restart();
@@ -2012,6 +2023,15 @@ Amr::timeStep (int  level,
         writePlotFile();
     }
     //
+    // Advance all levels together.
+    //
+    if (level == 0 && subcycling_mode == "Synchronous")
+    {
+        timeStepSynchronous(time);
+        which_level_being_advanced = -1;
+        return;
+    }
+    //
     // Advance grids at this level.
     //
     if (verbose > 0)
@@ -2021,9 +2041,18 @@ Amr::timeStep (int  level,
                        << " with dt = " << dt_level[level] << "\n";
     }
 
+    const double advance_start = amrex::second();
+
     Real dt_new = amr_level[level]->advance(time,dt_level[level],iteration,niter);
     BL_PROFILE_REGION_STOP("amr_level.advance");
 
+    if (subcycling_mode == "Optimal")
+    {
+        advance_time[level] += static_cast<Real>(amrex::second() - advance_start);
+        advance_cells[level] += static_cast<Real>(amr_level[level]->countCells());
+        if (level == 0) { ++timed_steps; }
+    }
+
     dt_min[level] = iteration == 1 ? dt_new : std::min(dt_min[level],dt_new);
 
     level_steps[level]++;
@@ -2084,6 +2113,59 @@ Amr::timeStep (int  level,
     which_level_being_advanced = -1;
 }
 
+void
+Amr::timeStepSynchronous (Real time)
+{
+    BL_PROFILE("Amr::timeStepSynchronous()");
+
+    if (verbose > 0)
+    {
+        amrex::Print() << "[Levels 0-" << finest_level << " step " << level_steps[0]+1 << "] "
+                       << "ADVANCE at time " << time
+                       << " with dt = " << dt_level[0] << "\n";
+    }
+
+    Vector<Real> dt_new(finest_level+1, dt_level[0]);
+    amr_level[0]->advanceSynchronous(time,dt_level[0],dt_new);
+
+    for (int lev = 0; lev <= finest_level; ++lev)
+    {
+        dt_min[lev] = dt_new[lev];
+        level_steps[lev]++;
+        level_count[lev]++;
+
+        if (verbose > 0)
+        {
+            amrex::Print() << "[Level " << lev << " step " << level_steps[lev] << "] "
+                           << "Advanced " << amr_level[lev]->countCells() << " cells\n";
+        }
+    }
+
+    for (int lev = finest_level; lev >= 0; --lev)
+    {
+        amr_level[lev]->post_timestep(1);
+    }
+
+    // If a level signified that it wants a regrid after the advance has
+    // occurred, do that now.  This comes after post_timestep, so that the
+    // levels are synchronized on the grids they were advanced on.
+    for (int lev = 0; lev <= finest_level; ++lev)
+    {
+        if (amr_level[lev]->postStepRegrid())
+        {
+            int old_finest = finest_level;
+
+            regrid(lev, time);
+
+            for (int k = old_finest + 1; k <= finest_level; ++k)
+            {
+                dt_level[k] = dt_level[k-1] / static_cast<Real>(n_cycle[k]);
+            }
+            break;
+        }
+    }
+}
+
 Real
 Amr::coarseTimeStepDt (Real stop_time)
 {
@@ -2108,6 +2190,10 @@ Amr::coarseTimeStep (Real stop_time)
     //
     if (levelSteps(0) > 0)
     {
+        if (subcycling_mode == "Optimal" && choose_subcycling) {
+            chooseOptimalSubcycling();
+        }
+
         int post_regrid_flag = 0;
         amr_level[0]->computeNewDt(finest_level,
                                    sub_cycle,
@@ -2579,6 +2665,9 @@ Amr::regrid (int  lbase,
         amrex::Print() << "Now regridding at level lbase = " << lbase << "\n";
     }
 
+    // The cost of the levels has changed.
+    choose_subcycling = true;
+
     //
     // Compute positions of new grids.
     //
@@ -3150,6 +3239,15 @@ Amr::initSubcycle ()
             n_cycle[i] = 1;
         }
     }
+    else if (subcycling_mode == "Synchronous")
+    {
+        // Like None, but all levels are advanced in one pass.
+        sub_cycle = false;
+        for (int i = 0; i <= max_level; i++)
+        {
+            n_cycle[i] = 1;
+        }
+    }
     else if (subcycling_mode == "Manual")
     {
         int cnt = pp.countval("subcycling_iterations");
@@ -3211,6 +3309,8 @@ Amr::initSubcycle ()
         {
             n_cycle[i] = MaxRefRatio(i-1);
         }
+        // Minimum number of coarse steps timed before a new pattern is chosen.
+        pp.queryAdd("subcycling_window",subcycling_window);
     }
     else
     {
@@ -3381,6 +3481,67 @@ Amr::computeOptimalSubcycling(int n, int* best, const Real* dt_max, const Real*
     return best_dt;
 }
 
+Real
+Amr::measuredWork (int lev) const
+{
+    const auto ncells = static_cast<Real>(amr_level[lev]->countCells());
+    for (int d = 0; d <= finest_level; ++d) {
+        for (int l : {lev-d, lev+d}) {
+            if (l >= 0 && l <= finest_level && cost_per_cell[l] > 0.0) {
+                return cost_per_cell[l]*ncells;
+            }
+        }
+    }
+    return ncells;
+}
+
+void
+Amr::chooseOptimalSubcycling ()
+{
+    BL_PROFILE("Amr::chooseOptimalSubcycling()");
+
+    if (timed_steps < subcycling_window) { return; }
+
+    const int nlev = finest_level+1;
+    for (int lev = 0; lev < nlev; ++lev) {
+        if (dt_min[lev] <= 0.0) { return; }
+    }
+
+    // The slowest process determines the cost.
+    Vector<Real> t(advance_time.begin(), advance_time.begin()+nlev);
+    ParallelDescriptor::ReduceRealMax(t.dataPtr(), nlev);
+    for (int lev = 0; lev < nlev; ++lev) {
+        if (t[lev] > 0.0 && advance_cells[lev] > 0.0) {
+            cost_per_cell[lev] = t[lev] / advance_cells[lev];
+        }
+    }
+    std::fill(advance_time.begin(), advance_time.end(), 0.0);
+    std::fill(advance_cells.begin(), advance_cells.end(), 0.0);
+    timed_steps = 0;
+
+    Vector<Real> work(nlev);
+    Vector<int> cycle_max(nlev);
+    Vector<int> best(nlev);
+    for (int lev = 0; lev < nlev; ++lev) {
+        work[lev] = measuredWork(lev);
+        cycle_max[lev] = (lev == 0) ? 1 : MaxRefRatio(lev-1);
+    }
+    computeOptimalSubcycling(nlev, best.dataPtr(), dt_min.dataPtr(), work.dataPtr(), cycle_max.dataPtr());
+
+    for (int lev = 0; lev < nlev; ++lev) {
+        n_cycle[lev] = best[lev];
+    }
+    choose_subcycling = false;
+
+    if (verbose > 0) {
+        amrex::Print() << "Optimal subcycling: n_cycle =";
+        for (int lev = 0; lev < nlev; ++lev) {
+            amrex::Print() << " " << n_cycle[lev];
+        }
+        amrex::Print() << "\n";
+    }
+}
+
 const Vector<BoxArray>& Amr::getInitialBA() noexcept
 {
   return initial_ba;
@@ -39,6 +39,15 @@ AmrLevel::post_timestep (int /*iteration*/)
     }
 }
 
+void
+AmrLevel::advanceSynchronous (Real time, Real dt, Vector<Real>& dt_new)
+{
+    AMREX_ASSERT(level == 0);
+    for (int lev = 0; lev <= parent->finestLevel(); ++lev) {
+        dt_new[lev] = parent->getLevel(lev).advance(time,dt,1,1);
+    }
+}
+
 void
 AmrLevel::postCoarseTimeStep (Real /*time*/)
 {
@@ -2052,7 +2061,7 @@ AmrLevel::which_time (int  indx, Real time) const noexcept
 Real
 AmrLevel::estimateWork ()
 {
-    return static_cast<Real>(countCells());
+    return parent->measuredWork(level);
 }
 
 bool
@@ -2170,8 +2179,10 @@ AmrLevel::FillPatcherFill (MultiFab& mf, int dcomp, int ncomp, int nghost,
         auto& fillpatcher = m_fillpatcher[state_index];
         if (fillpatcher == nullptr) {
             fillpatcher = std::make_unique<FillPatcher<MultiFab>>
-                (parent->boxArray(level), parent->DistributionMap(level), geom_fine,
-                 parent->boxArray(level-1), parent->DistributionMap(level-1), geom_crse,
+                (amrex::convert(parent->boxArray(level), desc.getType()),
+                 parent->DistributionMap(level), geom_fine,
+                 amrex::convert(parent->boxArray(level-1), desc.getType()),
+                 parent->DistributionMap(level-1), geom_crse,
                  IntVect(nghost), desc.nComp(), desc.interp(scomp));
         }
 
@@ -1,5 +1,7 @@
 
 #include <AMReX_AmrCore.H>
+#include <AMReX_CostTracker.H>
+#include <AMReX_Print.H>
 
 #ifdef AMREX_PARTICLES
 #include <AMReX_AmrParGDB.H>
@@ -10,6 +12,7 @@
 #endif
 
 #include <algorithm>
+#include <limits>
 #include <utility>
 #include <ostream>
 
@@ -135,6 +138,45 @@ AmrCore::regrid (int lbase, Real time, bool)
     finest_level = new_finest;
 }
 
+bool
+AmrCore::loadBalance (int lev, Real time, const LayoutData<Real>& costs, Real threshold)
+{
+    BL_PROFILE("AmrCore::loadBalance()");
+
+    AMREX_ALWAYS_ASSERT(lev <= finest_level &&
+                        costs.boxArray() == grids[lev] &&
+                        costs.DistributionMap() == dmap[lev]);
+
+    const Real current = costEfficiency(costs);
+    if (current >= threshold) { return false; }
+
+    Real eff[2] = {current, Real(0.0)};
+    const int root = ParallelDescriptor::IOProcessorNumber();
+    DistributionMapping new_dmap =
+        (DistributionMapping::strategy() == DistributionMapping::KNAPSACK)
+        ? DistributionMapping::makeKnapSack(costs, eff[0], eff[1],
+                                            std::numeric_limits<int>::max(), true, root)
+        : DistributionMapping::makeSFC(costs, eff[0], eff[1], true, root);
+    ParallelDescriptor::Bcast(eff, 2, root);
+
+    const bool rebalance = eff[1] > eff[0];
+
+    if (verbose > 0) {
+        amrex::Print() << "AmrCore::loadBalance: level " << lev << " efficiency "
+                       << eff[0] << ", proposed " << eff[1]
+                       << (rebalance ? ", rebalancing\n" : ", keeping the current mapping\n");
+    }
+
+    if (rebalance) {
+        const auto old_num_setdm = num_setdm;
+        RemakeLevel(lev, time, grids[lev], new_dmap);
+        if (old_num_setdm == num_setdm) {
+            SetDistributionMap(lev, new_dmap);
+        }
+    }
+
+    return rebalance;
+}
 
 void
 AmrCore::printGridSummary (std::ostream& os, int min_lev, int max_lev) const noexcept
@@ -11,6 +11,8 @@
 #include <AMReX_Bittree.H>
 #endif
 
+#include <algorithm>
+#include <map>
 #include <memory>
 
 namespace amrex {
@@ -113,6 +115,8 @@ AmrMesh::InitAmrMesh (int max_level_in, const Vector<int>& n_cell_in,
 
     pp.queryAdd("n_proper",n_proper);
     pp.queryAdd("grid_eff",grid_eff);
+    pp.queryAdd("distributed_clustering",use_distributed_clustering);
+    pp.queryAdd("tile_regrid",use_tile_regrid);
     int cnt = pp.countval("n_error_buf");
     if (cnt > 0) {
         Vector<int> neb;
@@ -463,11 +467,68 @@ AmrMesh::MakeDistributionMap (int lev, BoxArray const& ba)
     //     return DistributionMapping(ba);
     // } else
 #endif
-    {
+    if (use_tile_regrid && lev > 0) {
+        return MakeTileDistributionMap(lev, ba);
+    } else {
         return DistributionMapping(ba);
     }
 }
 
+DistributionMapping
+AmrMesh::MakeTileDistributionMap (int lev, BoxArray const& ba) const
+{
+    BL_PROFILE("AmrMesh::MakeTileDistributionMap()");
+
+    const int nprocs = ParallelDescriptor::NProcs();
+    const int nboxes = static_cast<int>(ba.size());
+    const int max_per_proc = (nboxes + nprocs - 1) / nprocs;
+
+    Vector<int> pmap(nboxes, -1);
+    Vector<int> count(nprocs, 0);
+
+    // The boxes that were already there keep their owner.
+    if (lev <= finest_level && !grids[lev].empty() && !dmap[lev].empty())
+    {
+        std::map<IntVect,int> old_owner;
+        for (int i = 0, N = static_cast<int>(grids[lev].size()); i < N; ++i) {
+            const Box b = grids[lev][i];
+            old_owner[b.smallEnd()] = i;
+        }
+        for (int i = 0; i < nboxes; ++i) {
+            const Box b = ba[i];
+            auto it = old_owner.find(b.smallEnd());
+            if (it != old_owner.end() && grids[lev][it->second] == b) {
+                pmap[i] = dmap[lev][it->second];
+                ++count[pmap[i]];
+            }
+        }
+    }
+
+    // The new boxes go to the owner of the coarse box under them, unless it
+    // already has its share, in which case they go to the least loaded process.
+    BoxArray const& cba = grids[lev-1];
+    DistributionMapping const& cdm = dmap[lev-1];
+    std::vector<std::pair<int,Box> > isects;
+    for (int i = 0; i < nboxes; ++i) {
+        if (pmap[i] >= 0) { continue; }
+        int owner = -1;
+        if (!cba.empty() && !cdm.empty()) {
+            cba.intersections(amrex::coarsen(ba[i],ref_ratio[lev-1]), isects, true, 0);
+            if (!isects.empty() && count[cdm[isects[0].first]] < max_per_proc) {
+                owner = cdm[isects[0].first];
+            }
+        }
+        if (owner < 0) {
+            owner = static_cast<int>(std::distance(count.begin(),
+                                                   std::min_element(count.begin(), count.end())));
+        }
+        pmap[i] = owner;
+        ++count[owner];
+    }
+
+    return DistributionMapping(std::move(pmap));
+}
+
 void
 AmrMesh::ChopGrids (int lev, BoxArray& ba, int target_size) const
 {
@@ -722,10 +783,18 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
         // Create initial cluster containing all tagged points.
         //
         Gpu::PinnedVector<IntVect> tagvec;
-        tags.collate(tagvec);
+        bool has_tags = false;
+        if (use_distributed_clustering || use_tile_regrid) {
+            tags.local_collate(tagvec);
+            has_tags = !tagvec.empty();
+            ParallelDescriptor::ReduceBoolOr(has_tags);
+        } else {
+            tags.collate(tagvec);
+            has_tags = !tagvec.empty();
+        }
         tags.clear();
 
-        if (!tagvec.empty())
+        if (has_tags)
         {
             //
             // Created new level, now generate efficient grids.
@@ -736,32 +805,94 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
 
             if (levf > useFixedUpToLevel()) {
                 BoxList new_bx;
-                if (ParallelDescriptor::IOProcessor()) {
-                    BL_PROFILE("AmrMesh-cluster");
+                if (use_tile_regrid) {
+                    BL_PROFILE("AmrMesh-tiles");
                     //
-                    // Construct initial cluster.
+                    // After coarsening by bf_lev, each tagged cell is a block of
+                    // blocking_factor[levf] cells at level levf.  Tags outside
+                    // the proper nesting domain have already been cleared, so
+                    // the blocks need no further clustering or intersection.
                     //
-                    ClusterList clist(tagvec.data(), static_cast<Long>(tagvec.size()));
-                    if (use_new_chop) {
-                        clist.new_chop(grid_eff);
-                    } else {
-                        clist.chop(grid_eff);
+                    Vector<Box> blocks;
+                    blocks.reserve(tagvec.size());
+                    for (auto const& iv : tagvec) {
+                        blocks.emplace_back(iv, iv);
                     }
-                    clist.intersect(p_n_ba[levc]);
+                    amrex::AllGatherBoxes(blocks);
+                    // Sort so that the BoxArray does not depend on the distribution of the tags.
+                    std::sort(blocks.begin(), blocks.end());
+                    new_bx = BoxList(std::move(blocks));
+                    new_bx.refine(bf_lev[levc]);
+                    new_bx.intersect(Geom(levc).Domain());
+                }
+                else if (use_distributed_clustering) {
+                    BL_PROFILE("AmrMesh-cluster-distributed");
                     //
-                    // Efficient properly nested Clusters have been constructed
-                    // now generate list of grids at level levf.
+                    // Each process clusters the tags it owns.  Since the grids
+                    // are distributed along a space filling curve, so are the
+                    // tags, and the clusters of a process are compact.
                     //
-                    clist.boxList(new_bx);
-                    new_bx.refine(bf_lev[levc]);
-                    new_bx.simplify();
-
-                    if (new_bx.size()>0) {
-                        // Chop new grids outside domain
+                    Vector<Box> local_bx;
+                    if (!tagvec.empty()) {
+                        ClusterList clist(tagvec.data(), static_cast<Long>(tagvec.size()));
+                        if (use_new_chop) {
+                            clist.new_chop(grid_eff);
+                        } else {
+                            clist.chop(grid_eff);
+                        }
+                        clist.intersect(p_n_ba[levc]);
+                        BoxList local_bl;
+                        clist.boxList(local_bl);
+                        local_bx = std::move(local_bl.data());
+                    }
+                    //
+                    // Merge the clusters of all processes.  The clusters of
+                    // different processes may overlap where the tags of one
+                    // process are in the bounding box of the tags of another,
+                    // so the overlaps are removed before the boxes are joined.
+                    // The boxes are only simplified once, after refinement, as
+                    // in the serial clustering, so that both give the same
+                    // grids when the tags are all on one process.
+                    //
+                    amrex::AllGatherBoxes(local_bx);
+                    if (!local_bx.empty()) {
+                        BoxArray cluster_ba(BoxList(std::move(local_bx)));
+                        cluster_ba.removeOverlap(false);
+                        new_bx = cluster_ba.boxList();
+                        new_bx.refine(bf_lev[levc]);
+                        new_bx.simplify();
                         new_bx.intersect(Geom(levc).Domain());
                     }
                 }
-                new_bx.Bcast();  // Broadcast the new BoxList to other processes
+                else
+                {
+                    if (ParallelDescriptor::IOProcessor()) {
+                        BL_PROFILE("AmrMesh-cluster");
+                        //
+                        // Construct initial cluster.
+                        //
+                        ClusterList clist(tagvec.data(), static_cast<Long>(tagvec.size()));
+                        if (use_new_chop) {
+                            clist.new_chop(grid_eff);
+                        } else {
+                            clist.chop(grid_eff);
+                        }
+                        clist.intersect(p_n_ba[levc]);
+                        //
+                        // Efficient properly nested Clusters have been constructed
+                        // now generate list of grids at level levf.
+                        //
+                        clist.boxList(new_bx);
+                        new_bx.refine(bf_lev[levc]);
+                        new_bx.simplify();
+
+                        if (new_bx.size()>0) {
+                            // Chop new grids outside domain
+                            new_bx.intersect(Geom(levc).Domain());
+                        }
+                    }
+                    new_bx.Bcast();  // Broadcast the new BoxList to other processes
+                }
 
                 bool odd_ref_ratio = false;
                 for (auto const& rr : ref_ratio[levc]) {
@@ -835,7 +966,7 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
                 amrex::Abort("AmrMesh::MakeNewGrids: how did this happen?");
             }
         }
-        else if (refine_grid_layout)
+        else if (refine_grid_layout && !use_tile_regrid)
         {
             ChopGrids(lev,new_grids[lev],ParallelDescriptor::NProcs());
             if (new_grids[lev] == grids[lev]) {
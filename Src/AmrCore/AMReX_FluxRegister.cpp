@@ -8,6 +8,50 @@
 
 namespace amrex {
 
+namespace {
+#ifdef AMREX_USE_GPU
+    struct FluxRegRefluxTag {
+        Array4<Real> dfab;
+        Array4<Real const> sfab;
+        Box dbox;
+        Dim3 offset;
+        Real sign;
+
+        [[nodiscard]] AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+        Box const& box () const noexcept { return dbox; }
+    };
+
+    struct FluxRegFineAddTag {
+        Array4<Real> reg;
+        Array4<Real const> flx;
+        Array4<Real const> area; //!< null if the fluxes are not multiplied by the area
+        Box rbox;
+
+        [[nodiscard]] AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+        Box const& box () const noexcept { return rbox; }
+    };
+
+    // Adds the fine fluxes to the registers of all the boxes in one launch.
+    void fluxreg_fineadd_tags (Vector<FluxRegFineAddTag> const& tags, int dir,
+                               Dim3 const& ratio, int destcomp, int srccomp,
+                               int numcomp, Real mult)
+    {
+        ParallelFor(tags,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, FluxRegFineAddTag const& tag) noexcept
+        {
+            const Box bx(IntVect(AMREX_D_DECL(i,j,k)), IntVect(AMREX_D_DECL(i,j,k)));
+            if (tag.area.p) {
+                fluxreg_fineareaadd(bx, tag.reg, destcomp, tag.area, tag.flx, srccomp,
+                                    numcomp, dir, ratio, mult);
+            } else {
+                fluxreg_fineadd(bx, tag.reg, destcomp, tag.flx, srccomp,
+                                numcomp, dir, ratio, mult);
+            }
+        });
+    }
+#endif
+}
+
 FluxRegister::FluxRegister ()
 {
     fine_level = ncomp = -1;
@@ -83,12 +127,35 @@ FluxRegister::define (const BoxArray&            fine_boxes,
         BndryRegister::define(lo_face,typ,0,1,0,nvar,dm);
         BndryRegister::define(hi_face,typ,0,1,0,nvar,dm);
     }
+
+    // The face of a low register is the high face of the coarse cell it
+    // corrects, and the face of a high register is its low face.
+    BoxList bl;
+    bl.reserve(2*AMREX_SPACEDIM*grids.size());
+    Vector<int> pmap;
+    pmap.reserve(2*AMREX_SPACEDIM*grids.size());
+    for (OrientationIter fi; fi; ++fi)
+    {
+        const Orientation face = fi();
+        const BoxArray& fba = bndry[face].boxArray();
+        for (int i = 0, N = static_cast<int>(fba.size()); i < N; ++i) {
+            Box bx = fba[i];
+            bx.setType(IndexType::TheCellType());
+            if (face.isLow()) { bx.shift(face.coordDir(), -1); }
+            bl.push_back(bx);
+            pmap.push_back(dm[i]);
+        }
+    }
+    m_reflux_ba = BoxArray(std::move(bl));
+    m_reflux_dm = DistributionMapping(std::move(pmap));
 }
 
 void
 FluxRegister::clear ()
 {
     BndryRegister::clear();
+    m_reflux_ba = BoxArray();
+    m_reflux_dm = DistributionMapping();
 }
 
 Real
@@ -205,57 +272,66 @@ FluxRegister::CrseInit (const MultiFab& mflx,
         }
     }
 
+    // The copies to the low and high faces are in flight together.
+    if (op == FluxRegister::COPY)
+    {
+        bndry[face_lo].m_mf.ParallelCopy_nowait(mf,0,destcomp,numcomp,0,0);
+        bndry[face_hi].m_mf.ParallelCopy_nowait(mf,0,destcomp,numcomp,0,0);
+        bndry[face_lo].m_mf.ParallelCopy_finish();
+        bndry[face_hi].m_mf.ParallelCopy_finish();
+        return;
+    }
+
+    Array<FabSet,2> fsets;
     for (int pass = 0; pass < 2; pass++)
     {
         const Orientation face = ((pass == 0) ? face_lo : face_hi);
+        fsets[pass].define(bndry[face].boxArray(),bndry[face].DistributionMap(),numcomp);
+        fsets[pass].setVal(0);
+        fsets[pass].m_mf.ParallelCopy_nowait(mf,0,0,numcomp,0,0);
+    }
 
-        if (op == FluxRegister::COPY)
-        {
-            bndry[face].copyFrom(mf,0,0,destcomp,numcomp);
-        }
-        else
-        {
-            FabSet fs(bndry[face].boxArray(),bndry[face].DistributionMap(),numcomp);
-
-            fs.setVal(0);
+    for (int pass = 0; pass < 2; pass++)
+    {
+        const Orientation face = ((pass == 0) ? face_lo : face_hi);
+        FabSet& fs = fsets[pass];
 
-            fs.copyFrom(mf,0,0,0,numcomp);
+        fs.m_mf.ParallelCopy_finish();
 
 #ifdef AMREX_USE_GPU
-            using Tag = Array4PairTag<Real>;
-            Vector<Tag> tags;
-            tags.reserve(mflx.local_size()*AMREX_SPACEDIM*2);
+        using Tag = Array4PairTag<Real>;
+        Vector<Tag> tags;
+        tags.reserve(mflx.local_size()*AMREX_SPACEDIM*2);
 #endif
 
 #ifdef AMREX_USE_OMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
-            for (FabSetIter mfi(fs); mfi.isValid(); ++mfi)
-            {
-                const Box& bx = mfi.validbox();
-                auto const sfab = fs.const_array(mfi);
-                auto       dfab = bndry[face].array(mfi);
+        for (FabSetIter mfi(fs); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            auto const sfab = fs.const_array(mfi);
+            auto       dfab = bndry[face].array(mfi);
 #ifdef AMREX_USE_GPU
-                if (Gpu::inLaunchRegion()) {
-                    tags.push_back({dfab, sfab, bx});
-                } else
+            if (Gpu::inLaunchRegion()) {
+                tags.push_back({dfab, sfab, bx});
+            } else
 #endif
+            {
+                AMREX_LOOP_4D(bx, numcomp, i, j, k, n,
                 {
-                    AMREX_LOOP_4D(bx, numcomp, i, j, k, n,
-                    {
-                        dfab(i,j,k,n+destcomp) += sfab(i,j,k,n);
-                    });
-                }
+                    dfab(i,j,k,n+destcomp) += sfab(i,j,k,n);
+                });
             }
+        }
 
 #ifdef AMREX_USE_GPU
-            ParallelFor(tags, numcomp,
-            [=] AMREX_GPU_DEVICE (int i, int j, int k, int n, Tag const& tag) noexcept
-            {
-                tag.dfab(i,j,k,n+destcomp) += tag.sfab(i,j,k,n);
-            });
+        ParallelFor(tags, numcomp,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n, Tag const& tag) noexcept
+        {
+            tag.dfab(i,j,k,n+destcomp) += tag.sfab(i,j,k,n);
+        });
 #endif
-        }
     }
 }
 
@@ -328,10 +404,16 @@ FluxRegister::CrseAdd (const MultiFab& mflx,
         }
     }
 
+    // The additions to the low and high faces are in flight together.
     for (int pass = 0; pass < 2; pass++)
     {
         const Orientation face = ((pass == 0) ? face_lo : face_hi);
-        bndry[face].plusFrom(mf,0,0,destcomp,numcomp,geom.periodicity());
+        bndry[face].m_mf.ParallelAdd_nowait(mf,0,destcomp,numcomp,0,0,geom.periodicity());
+    }
+    for (int pass = 0; pass < 2; pass++)
+    {
+        const Orientation face = ((pass == 0) ? face_lo : face_hi);
+        bndry[face].m_mf.ParallelCopy_finish();
     }
 }
 
@@ -363,6 +445,23 @@ FluxRegister::FineAdd (const MultiFab& mflx,
                        int             numcomp,
                        Real            mult)
 {
+#ifdef AMREX_USE_GPU
+    if (Gpu::inLaunchRegion()) {
+        Vector<FluxRegFineAddTag> tags;
+        tags.reserve(2*mflx.local_size());
+        for (MFIter mfi(mflx); mfi.isValid(); ++mfi) {
+            for (auto const& face : {Orientation(dir,Orientation::low),
+                                     Orientation(dir,Orientation::high)}) {
+                FArrayBox& reg = bndry[face][mfi.index()];
+                tags.push_back({reg.array(), mflx.const_array(mfi),
+                                Array4<Real const>{}, reg.box()});
+            }
+        }
+        fluxreg_fineadd_tags(tags, dir, ratio.dim3(), destcomp, srccomp, numcomp, mult);
+        return;
+    }
+#endif
+
 #ifdef AMREX_USE_OMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
@@ -382,6 +481,23 @@ FluxRegister::FineAdd (const MultiFab& mflx,
                        int             numcomp,
                        Real            mult)
 {
+#ifdef AMREX_USE_GPU
+    if (Gpu::inLaunchRegion()) {
+        Vector<FluxRegFineAddTag> tags;
+        tags.reserve(2*mflx.local_size());
+        for (MFIter mfi(mflx); mfi.isValid(); ++mfi) {
+            for (auto const& face : {Orientation(dir,Orientation::low),
+                                     Orientation(dir,Orientation::high)}) {
+                FArrayBox& reg = bndry[face][mfi.index()];
+                tags.push_back({reg.array(), mflx.const_array(mfi),
+                                area.const_array(mfi), reg.box()});
+            }
+        }
+        fluxreg_fineadd_tags(tags, dir, ratio.dim3(), destcomp, srccomp, numcomp, mult);
+        return;
+    }
+#endif
+
 #ifdef AMREX_USE_OMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
@@ -528,10 +644,86 @@ FluxRegister::Reflux (MultiFab&       mf,
                       int             nc,
                       const Geometry& geom)
 {
-    for (OrientationIter fi; fi; ++fi)
+    BL_PROFILE("FluxRegister::Reflux()");
+
+    BL_ASSERT(scomp >= 0 && scomp+nc <= ncomp);
+
+    // Put the correction of every face on the coarse cell it applies to.
+    MultiFab fcorr(m_reflux_ba, m_reflux_dm, nc, 0);
+
+    const int nboxes = static_cast<int>(grids.size());
+
+#ifdef AMREX_USE_GPU
+    Vector<FluxRegRefluxTag> tags;
+    tags.reserve(fcorr.local_size());
+#endif
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(fcorr); mfi.isValid(); ++mfi)
     {
-        const Orientation& face = fi();
-        Reflux(mf, volume, face, scale, scomp, dcomp, nc, geom);
+        const int f = mfi.index() / nboxes;
+        const Orientation face(f % AMREX_SPACEDIM, Orientation::Side(f / AMREX_SPACEDIM));
+        const Box& bx = mfi.validbox();
+        auto const& dfab = fcorr.array(mfi);
+        auto const& sfab = bndry[face][mfi.index()-f*nboxes].const_array(scomp);
+        const Dim3 offset = face.isLow() ? IntVect::TheDimensionVector(face.coordDir()).dim3()
+                                         : Dim3{0,0,0};
+        const Real sign = face.isLow() ? Real(-1.0) : Real(1.0);
+#ifdef AMREX_USE_GPU
+        if (Gpu::inLaunchRegion()) {
+            tags.push_back({dfab, sfab, bx, offset, sign});
+        } else
+#endif
+        {
+            AMREX_LOOP_4D(bx, nc, i, j, k, n,
+            {
+                dfab(i,j,k,n) = sign*sfab(i+offset.x,j+offset.y,k+offset.z,n);
+            });
+        }
+    }
+
+#ifdef AMREX_USE_GPU
+    ParallelFor(tags, nc,
+    [=] AMREX_GPU_DEVICE (int i, int j, int k, int n, FluxRegRefluxTag const& tag) noexcept
+    {
+        tag.dfab(i,j,k,n) = tag.sign*tag.sfab(i+tag.offset.x,j+tag.offset.y,k+tag.offset.z,n);
+    });
+#endif
+
+    MultiFab corr(mf.boxArray(), mf.DistributionMap(), nc, 0, MFInfo(), mf.Factory());
+    corr.setVal(0.0);
+    corr.ParallelAdd(fcorr, 0, 0, nc, geom.periodicity());
+
+#ifdef AMREX_USE_GPU
+    if (Gpu::inLaunchRegion() && mf.isFusingCandidate()) {
+        auto const& sma = mf.arrays();
+        auto const& cma = corr.const_arrays();
+        auto const& vma = volume.const_arrays();
+        ParallelFor(mf, IntVect(0), nc,
+        [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k, int n) noexcept
+        {
+            sma[box_no](i,j,k,n+dcomp) += scale*cma[box_no](i,j,k,n)/vma[box_no](i,j,k);
+        });
+        Gpu::streamSynchronize();
+    } else
+#endif
+    {
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(mf,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            Array4<Real> const& sfab = mf.array(mfi);
+            Array4<Real const> const& cfab = corr.const_array(mfi);
+            Array4<Real const> const& vfab = volume.const_array(mfi);
+            AMREX_HOST_DEVICE_PARALLEL_FOR_4D ( bx, nc, i, j, k, n,
+            {
+                sfab(i,j,k,n+dcomp) += scale*cfab(i,j,k,n)/vfab(i,j,k);
+            });
+        }
     }
 }
 
@@ -23,6 +23,8 @@ namespace amrex {
  *
  * CellConservativeQuartic only works with ref ratio of 2 on cpu and gpu.
  *
+ * CellConservativeWENO works in 1D, 2D and 3D on cpu and gpu with any ref ratio.
+ *
  * FaceConservativeLinear works in 2D and 3D on cpu and gpu.
  *
  * FaceDivFree works in 2D and 3D on cpu and gpu.
@@ -44,6 +46,7 @@ CellConservativeQuartic   quartic_interp;
 CellBilinear              cell_bilinear_interp;
 CellQuadratic             quadratic_interp;
 CellQuartic               cell_quartic_interp;
+CellConservativeWENO      weno_interp;
 
 Box
 NodeBilinear::CoarseBox (const Box& fine,
@@ -1435,4 +1438,101 @@ CellQuartic::interp (const FArrayBox& crse,
     });
 }
 
+
+Box
+CellConservativeWENO::CoarseBox (const Box& fine, const IntVect& ratio)
+{
+    Box crse = amrex::coarsen(fine,ratio);
+    crse.grow(2);
+    return crse;
+}
+
+Box
+CellConservativeWENO::CoarseBox (const Box& fine, int ratio)
+{
+    Box crse = amrex::coarsen(fine,ratio);
+    crse.grow(2);
+    return crse;
+}
+
+void
+CellConservativeWENO::interp (const FArrayBox& crse,
+                              int              crse_comp,
+                              FArrayBox&       fine,
+                              int              fine_comp,
+                              int              ncomp,
+                              const Box&       fine_region,
+                              const IntVect&   ratio,
+                              const Geometry&  /*crse_geom*/,
+                              const Geometry&  /*fine_geom*/,
+                              Vector<BCRec> const&  /*bcr*/,
+                              int              /* actual_comp */,
+                              int              /* actual_state */,
+                              RunOn            runon)
+{
+    BL_PROFILE("CellConservativeWENO::interp()");
+
+    Box target_fine_region = fine_region & fine.box();
+    if (!target_fine_region.ok()) { return; }
+
+    bool run_on_gpu = (runon == RunOn::Gpu && Gpu::inLaunchRegion());
+    amrex::ignore_unused(run_on_gpu);
+
+    Array4<Real const> const& crsearr = crse.const_array(crse_comp);
+    Array4<Real>       const& finearr = fine.array(fine_comp);
+
+    // The interpolation is done one direction at a time, from the last
+    // direction to the first, on the coarse cells in the directions that
+    // have not been done yet.
+
+#if (AMREX_SPACEDIM == 3)
+    const int rz = ratio[2];
+    Box bz = amrex::coarsen(target_fine_region, IntVect(ratio[0],ratio[1],1));
+    bz.grow(IntVect(2,2,0));
+    FArrayBox tmpz(bz, ncomp);
+#ifdef AMREX_USE_GPU
+    Elixir tmpz_eli;
+    if (run_on_gpu) { tmpz_eli = tmpz.elixir(); }
+#endif
+    Array4<Real> const& tmpzarr = tmpz.array();
+    AMREX_HOST_DEVICE_PARALLEL_FOR_4D_FLAG(runon, bz, ncomp, i, j, k, n,
+    {
+        cell_weno_interp<2>(i,j,k,n,tmpzarr,crsearr,rz);
+    });
+#endif
+
+#if (AMREX_SPACEDIM >= 2)
+    const int ry = ratio[1];
+    Box by = amrex::coarsen(target_fine_region, IntVect(AMREX_D_DECL(ratio[0],1,1)));
+    by.grow(IntVect(AMREX_D_DECL(2,0,0)));
+    FArrayBox tmpy(by, ncomp);
+#ifdef AMREX_USE_GPU
+    Elixir tmpy_eli;
+    if (run_on_gpu) { tmpy_eli = tmpy.elixir(); }
+#endif
+    Array4<Real> const& tmpyarr = tmpy.array();
+#if (AMREX_SPACEDIM == 2)
+    Array4<Real const> srcarr = crsearr;
+#else
+    Array4<Real const> srcarr = tmpz.const_array();
+#endif
+    AMREX_HOST_DEVICE_PARALLEL_FOR_4D_FLAG(runon, by, ncomp, i, j, k, n,
+    {
+        cell_weno_interp<1>(i,j,k,n,tmpyarr,srcarr,ry);
+    });
+#endif
+
+#if (AMREX_SPACEDIM == 1)
+    Array4<Real const> srcarr = crsearr;
+#else
+    srcarr = tmpy.const_array();
+#endif
+    const int rx = ratio[0];
+    AMREX_HOST_DEVICE_PARALLEL_FOR_4D_FLAG(runon, target_fine_region, ncomp,
+                                           i, j, k, n,
+    {
+        cell_weno_interp<0>(i,j,k,n,finearr,srcarr,rx);
+    });
+}
+
 }
@@ -1,6 +1,7 @@
 #include <AMReX_Interp_C.H>
 #include <AMReX_MFInterp_C.H>
 #include <AMReX_MFInterpolater.H>
+#include <AMReX_Interpolater.H>
 #include <AMReX_Geometry.H>
 #include <AMReX_MultiFab.H>
 
@@ -12,6 +13,7 @@ MFCellConsLinInterp mf_cell_cons_interp(false);
 MFCellConsLinInterp mf_lincc_interp(true);
 MFCellConsLinMinmaxLimitInterp mf_linear_slope_minmax_interp;
 MFCellBilinear      mf_cell_bilinear_interp;
+MFCellConsWENOInterp mf_weno_interp;
 
 // Nodal
 MFNodeBilinear      mf_node_bilinear_interp;
@@ -477,6 +479,121 @@ MFCellBilinear::interp (MultiFab const& crsemf, int ccomp, MultiFab& finemf, int
     }
 }
 
+Box
+MFCellConsWENOInterp::CoarseBox (const Box& fine, const IntVect& ratio)
+{
+    Box crse = amrex::coarsen(fine,ratio);
+    crse.grow(2);
+    return crse;
+}
+
+Box
+MFCellConsWENOInterp::CoarseBox (const Box& fine, int ratio)
+{
+    return CoarseBox(fine,IntVect(ratio));
+}
+
+void
+MFCellConsWENOInterp::interp (MultiFab const& crsemf, int ccomp, MultiFab& finemf, int fcomp, int nc,
+                              IntVect const& ng, Geometry const& cgeom, Geometry const& fgeom,
+                              Box const& dest_domain, IntVect const& ratio,
+                              Vector<BCRec> const& bcs, int bcscomp)
+{
+    AMREX_ASSERT(crsemf.nGrowVect() == 0);
+
+#ifdef AMREX_USE_GPU
+    if (Gpu::inLaunchRegion()) {
+        // The directions are done one at a time as in CellConservativeWENO,
+        // but each sweep is a single launch over all the boxes.  Boxes that
+        // have no cells in dest_domain are skipped, because growing their
+        // empty region would give a box that is not covered by crsemf.
+        Vector<Box> fboxes;
+        Vector<int> fidx;
+        for (MFIter mfi(finemf); mfi.isValid(); ++mfi) {
+            Box const& fbox = amrex::grow(mfi.validbox(),ng) & dest_domain;
+            if (fbox.ok()) {
+                fboxes.push_back(fbox);
+                fidx.push_back(mfi.index());
+            }
+        }
+        const int nboxes = static_cast<int>(fboxes.size());
+        if (nboxes == 0) { return; }
+
+        Vector<Array4CopyTag<Real>> tags;
+        tags.reserve(nboxes);
+
+#if (AMREX_SPACEDIM == 3)
+        Vector<FArrayBox> tmpz;
+        tmpz.reserve(nboxes);
+        for (int ibox = 0; ibox < nboxes; ++ibox) {
+            Box const& bz = amrex::grow(amrex::coarsen(fboxes[ibox], IntVect(ratio[0],ratio[1],1)),
+                                        IntVect(2,2,0));
+            tmpz.emplace_back(bz, nc, The_Async_Arena());
+            tags.push_back({tmpz[ibox].array(), crsemf.const_array(fidx[ibox],ccomp), bz,
+                            Dim3{0,0,0}});
+        }
+        const int rz = ratio[2];
+        ParallelFor(tags, nc,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n, Array4CopyTag<Real> const& tag) noexcept
+        {
+            cell_weno_interp<2>(i,j,k,n, tag.dfab, tag.sfab, rz);
+        });
+        tags.clear();
+#endif
+
+#if (AMREX_SPACEDIM >= 2)
+        Vector<FArrayBox> tmpy;
+        tmpy.reserve(nboxes);
+        for (int ibox = 0; ibox < nboxes; ++ibox) {
+            Box const& by = amrex::grow(amrex::coarsen(fboxes[ibox], IntVect(AMREX_D_DECL(ratio[0],1,1))),
+                                        IntVect(AMREX_D_DECL(2,0,0)));
+            tmpy.emplace_back(by, nc, The_Async_Arena());
+#if (AMREX_SPACEDIM == 3)
+            Array4<Real const> const& src = tmpz[ibox].const_array();
+#else
+            Array4<Real const> const& src = crsemf.const_array(fidx[ibox],ccomp);
+#endif
+            tags.push_back({tmpy[ibox].array(), src, by, Dim3{0,0,0}});
+        }
+        const int ry = ratio[1];
+        ParallelFor(tags, nc,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n, Array4CopyTag<Real> const& tag) noexcept
+        {
+            cell_weno_interp<1>(i,j,k,n, tag.dfab, tag.sfab, ry);
+        });
+        tags.clear();
+#endif
+
+        for (int ibox = 0; ibox < nboxes; ++ibox) {
+#if (AMREX_SPACEDIM == 1)
+            Array4<Real const> const& xsrc = crsemf.const_array(fidx[ibox],ccomp);
+#else
+            Array4<Real const> const& xsrc = tmpy[ibox].const_array();
+#endif
+            tags.push_back({finemf.array(fidx[ibox],fcomp), xsrc, fboxes[ibox], Dim3{0,0,0}});
+        }
+        const int rx = ratio[0];
+        ParallelFor(tags, nc,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n, Array4CopyTag<Real> const& tag) noexcept
+        {
+            cell_weno_interp<0>(i,j,k,n, tag.dfab, tag.sfab, rx);
+        });
+        Gpu::streamSynchronize();
+    } else
+#endif
+    {
+        amrex::ignore_unused(bcscomp);
+#ifdef AMREX_USE_OMP
+#pragma omp parallel
+#endif
+        for (MFIter mfi(finemf); mfi.isValid(); ++mfi) {
+            Box const& fbox = amrex::grow(mfi.validbox(),ng) & dest_domain;
+            weno_interp.interp(crsemf[mfi], ccomp, finemf[mfi], fcomp, nc, fbox, ratio,
+                               cgeom, fgeom, bcs, 0, 0, RunOn::Cpu);
+        }
+    }
+}
+
 Box
 MFNodeBilinear::CoarseBox (const Box& fine, const IntVect& ratio)
 {
@@ -10,9 +10,25 @@
 #include <cstdlib>
 #include <cmath>
 #include <climits>
+#include <cstdint>
 
 namespace amrex {
 
+namespace {
+    //! The 64 bits of a row of tag bits starting at bit p, which may be outside the row.
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    std::uint64_t tagbox_bits (Array4<std::uint64_t const> const& m, int p, int nw,
+                               int j, int k) noexcept
+    {
+        const int q = (p >= 0) ? p/64 : -((63-p)/64);
+        const int r = p - 64*q;
+        const std::uint64_t wlo = (q >= 0 && q < nw) ? m(q,j,k) : 0;
+        if (r == 0) { return wlo; }
+        const std::uint64_t whi = (q+1 >= 0 && q+1 < nw) ? m(q+1,j,k) : 0;
+        return (wlo >> r) | (whi << (64-r));
+    }
+}
+
 TagBox::TagBox (Arena* ar) noexcept
     : BaseFab<TagBox::TagType>(ar)
 {}
@@ -43,6 +59,9 @@ TagBox::coarsen (const IntVect& ratio, const Box& cbox) noexcept
     Dim3 r{1,1,1};
     AMREX_D_TERM(r.x = ratio[0];, r.y = ratio[1];, r.z = ratio[2]);
 
+    // Unlike buffer, this works on the chars rather than on bit masks,
+    // because the coarse tag is the maximum of SET, BUF and CLEAR, not
+    // just whether any fine cell is tagged.
     AMREX_HOST_DEVICE_FOR_3D(cbox, i, j, k,
     {
         TagType t = TagBox::CLEAR;
@@ -75,48 +94,77 @@ TagBox::coarsen (const IntVect& ratio, const Box& cbox) noexcept
 void
 TagBox::buffer (const IntVect& a_nbuff, const IntVect& a_nwid) noexcept
 {
+    // The SET cells in the interior are dilated as bit masks, with a word
+    // for 64 cells in the x-direction, one direction at a time.
     Box const& interior = amrex::grow(domain, -a_nwid);
     Dim3 nbuf = a_nbuff.dim3();
     Array4<char> const& a = this->array();
-#ifdef AMREX_USE_GPU
-    if (Gpu::inLaunchRegion()) {
-        Box const& interiorplusbuf = amrex::grow(interior, a_nbuff);
-        const auto lo = amrex::lbound(interiorplusbuf);
-        const auto hi = amrex::ubound(interiorplusbuf);
-        AMREX_HOST_DEVICE_FOR_3D(interiorplusbuf, i, j, k,
+
+    const auto lo = amrex::lbound(domain);
+    const auto hi = amrex::ubound(domain);
+    const int nw = (hi.x-lo.x+64) / 64;
+    Box const wbox(IntVect(AMREX_D_DECL(0,lo.y,lo.z)), IntVect(AMREX_D_DECL(nw-1,hi.y,hi.z)));
+
+    BaseFab<std::uint64_t> mfab(wbox, 2, The_Arena());
+    Elixir eli = mfab.elixir();
+    Array4<std::uint64_t> src = mfab.array(0);
+    Array4<std::uint64_t> dst = mfab.array(1);
+
+    AMREX_HOST_DEVICE_FOR_3D(wbox, w, j, k,
+    {
+        std::uint64_t word = 0;
+        for (int b = 0; b < 64; ++b) {
+            const int i = lo.x + 64*w + b;
+            if (interior.contains(i,j,k) && a(i,j,k) == TagBox::SET) {
+                word |= std::uint64_t(1) << b;
+            }
+        }
+        src(w,j,k) = word;
+    });
+
+    if (nbuf.x > 0) {
+        AMREX_HOST_DEVICE_FOR_3D(wbox, w, j, k,
         {
-            if (a(i,j,k) == TagBox::CLEAR) {
-                bool to_buf = false;
-                int imin = amrex::max(i-nbuf.x, lo.x);
-                int jmin = amrex::max(j-nbuf.y, lo.y);
-                int kmin = amrex::max(k-nbuf.z, lo.z);
-                int imax = amrex::min(i+nbuf.x, hi.x);
-                int jmax = amrex::min(j+nbuf.y, hi.y);
-                int kmax = amrex::min(k+nbuf.z, hi.z);
-                // xxxxx TODO: If nbuf is large, this is not efficient.
-                //             We need to find another better way.
-                for (int kk = kmin; kk <= kmax && !to_buf; ++kk) {
-                for (int jj = jmin; jj <= jmax && !to_buf; ++jj) {
-                for (int ii = imin; ii <= imax && !to_buf; ++ii) {
-                    if (a(ii,jj,kk) == TagBox::SET) { to_buf = true; }
-                }}}
-                if (to_buf) { a(i,j,k) = TagBox::BUF; }
+            std::uint64_t word = 0;
+            for (int s = -nbuf.x; s <= nbuf.x; ++s) {
+                word |= tagbox_bits(src, 64*w+s, nw, j, k);
             }
+            dst(w,j,k) = word;
         });
-    } else
-#endif
-    {
-        AMREX_LOOP_3D(interior, i, j, k,
+        std::swap(src, dst);
+    }
+
+    if (nbuf.y > 0) {
+        AMREX_HOST_DEVICE_FOR_3D(wbox, w, j, k,
         {
-            if (a(i,j,k) == TagBox::SET) {
-                for (int kk = k-nbuf.z; kk <= k+nbuf.z; ++kk) {
-                for (int jj = j-nbuf.y; jj <= j+nbuf.y; ++jj) {
-                for (int ii = i-nbuf.x; ii <= i+nbuf.x; ++ii) {
-                    if (a(ii,jj,kk) == TagBox::CLEAR) { a(ii,jj,kk) = TagBox::BUF; }
-                }}}
+            std::uint64_t word = 0;
+            for (int jj = amrex::max(j-nbuf.y,lo.y); jj <= amrex::min(j+nbuf.y,hi.y); ++jj) {
+                word |= src(w,jj,k);
             }
+            dst(w,j,k) = word;
         });
+        std::swap(src, dst);
     }
+
+    if (nbuf.z > 0) {
+        AMREX_HOST_DEVICE_FOR_3D(wbox, w, j, k,
+        {
+            std::uint64_t word = 0;
+            for (int kk = amrex::max(k-nbuf.z,lo.z); kk <= amrex::min(k+nbuf.z,hi.z); ++kk) {
+                word |= src(w,j,kk);
+            }
+            dst(w,j,k) = word;
+        });
+        std::swap(src, dst);
+    }
+
+    AMREX_HOST_DEVICE_FOR_3D(domain, i, j, k,
+    {
+        const int p = i - lo.x;
+        if (a(i,j,k) == TagBox::CLEAR && ((src(p/64,j,k) >> (p%64)) & 1)) {
+            a(i,j,k) = TagBox::BUF;
+        }
+    });
 }
 
 // DEPRECATED
@@ -589,19 +637,27 @@ TagBoxArray::local_collate_gpu (Gpu::PinnedVector<IntVect>& v) const
 #endif
 
 void
-TagBoxArray::collate (Gpu::PinnedVector<IntVect>& TheGlobalCollateSpace) const
+TagBoxArray::local_collate (Gpu::PinnedVector<IntVect>& v) const
 {
-    BL_PROFILE("TagBoxArray::collate()");
+    BL_PROFILE("TagBoxArray::local_collate()");
 
-    Gpu::PinnedVector<IntVect> TheLocalCollateSpace;
 #ifdef AMREX_USE_GPU
     if (Gpu::inLaunchRegion()) {
-        local_collate_gpu(TheLocalCollateSpace);
+        local_collate_gpu(v);
     } else
 #endif
     {
-        local_collate_cpu(TheLocalCollateSpace);
+        local_collate_cpu(v);
     }
+}
+
+void
+TagBoxArray::collate (Gpu::PinnedVector<IntVect>& TheGlobalCollateSpace) const
+{
+    BL_PROFILE("TagBoxArray::collate()");
+
+    Gpu::PinnedVector<IntVect> TheLocalCollateSpace;
+    local_collate(TheLocalCollateSpace);
 
     Long count = static_cast<Long>(TheLocalCollateSpace.size());
 
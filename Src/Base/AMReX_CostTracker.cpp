@@ -0,0 +1,112 @@
+#include <AMReX_CostTracker.H>
+#include <AMReX_GpuDevice.H>
+#include <AMReX_ParallelReduce.H>
+#include <AMReX_Utility.H>
+
+namespace amrex {
+
+CostTracker::Timer::Timer (CostTracker& tracker, const MFIter& mfi, Kind kind) noexcept
+    : m_tracker(&tracker), m_box(mfi.index()), m_kind(kind), m_start(amrex::second())
+{}
+
+CostTracker::Timer::~Timer ()
+{
+#ifdef AMREX_USE_GPU
+    if (Gpu::inLaunchRegion()) { Gpu::streamSynchronize(); }
+#endif
+    m_tracker->addTime(m_box, m_kind, Real(amrex::second() - m_start));
+}
+
+void
+CostTracker::define (const BoxArray& ba, const DistributionMapping& dm)
+{
+    for (int k = 0; k < 2; ++k) {
+        m_time[k].define(ba, dm);
+        m_count[k].define(ba, dm);
+        for (int i = 0; i < m_time[k].local_size(); ++i) {
+            m_time[k].data()[i] = Real(0.0);
+            m_count[k].data()[i] = Real(0.0);
+        }
+    }
+
+    auto& ncells = m_count[static_cast<int>(Kind::Cells)];
+    for (MFIter mfi(ncells); mfi.isValid(); ++mfi) {
+        ncells[mfi] = Real(ba[mfi.index()].d_numPts());
+    }
+}
+
+void
+CostTracker::reset ()
+{
+    for (auto& t : m_time) {
+        for (int i = 0; i < t.local_size(); ++i) { t.data()[i] = Real(0.0); }
+    }
+}
+
+void
+CostTracker::addTime (int i, Kind kind, Real seconds) noexcept
+{
+    Real& t = m_time[static_cast<int>(kind)][i];
+#ifdef AMREX_USE_OMP
+#pragma omp atomic
+#endif
+    t += seconds;
+}
+
+void
+CostTracker::calibrate ()
+{
+    // Local sums of the times and counts of both kinds
+    Real sums[4] = {Real(0.0), Real(0.0), Real(0.0), Real(0.0)};
+    for (int k = 0; k < 2; ++k) {
+        for (int i = 0; i < m_time[k].local_size(); ++i) {
+            sums[k]   += m_time[k].data()[i];
+            sums[k+2] += m_count[k].data()[i];
+        }
+    }
+    ParallelAllReduce::Sum(sums, 4, ParallelContext::CommunicatorSub());
+
+    for (int k = 0; k < 2; ++k) {
+        if (sums[k] > Real(0.0) && sums[k+2] > Real(0.0)) {
+            m_coeff[k] = sums[k] / sums[k+2];
+        }
+    }
+}
+
+LayoutData<Real>
+CostTracker::getCosts (bool use_model) const
+{
+    LayoutData<Real> r(boxArray(), DistributionMap());
+    for (int i = 0; i < r.local_size(); ++i) {
+        if (use_model) {
+            r.data()[i] = m_coeff[0] * m_count[0].data()[i]
+                +         m_coeff[1] * m_count[1].data()[i];
+        } else {
+            r.data()[i] = m_time[0].data()[i] + m_time[1].data()[i];
+        }
+    }
+    return r;
+}
+
+Real
+CostTracker::efficiency (bool use_model) const
+{
+    return costEfficiency(getCosts(use_model));
+}
+
+Real
+costEfficiency (const LayoutData<Real>& costs)
+{
+    Real local = Real(0.0);
+    for (int i = 0; i < costs.local_size(); ++i) {
+        local += costs.data()[i];
+    }
+    Real total = local;
+    Real maxcost = local;
+    ParallelAllReduce::Sum(total, ParallelContext::CommunicatorSub());
+    ParallelAllReduce::Max(maxcost, ParallelContext::CommunicatorSub());
+    if (maxcost <= Real(0.0)) { return Real(1.0); }
+    return total / (Real(ParallelContext::NProcsSub()) * maxcost);
+}
+
+}
@@ -0,0 +1,173 @@
+#include <AMReX_FFT.H>
+#include <AMReX_BLassert.H>
+#include <AMReX_Math.H>
+
+#include <algorithm>
+#include <cmath>
+
+namespace amrex::FFT
+{
+
+Plan1D::Plan1D (int n)
+    : m_n(n)
+{
+    AMREX_ALWAYS_ASSERT(n > 0);
+
+    int r = n;
+    for (int p : {4, 2, 3, 5}) {
+        while (r % p == 0) {
+            m_factors.push_back(p);
+            r /= p;
+        }
+    }
+    for (int p = 7; p*p <= r; p += 2) {
+        while (r % p == 0) {
+            m_factors.push_back(p);
+            r /= p;
+        }
+    }
+    if (r > 1) { m_factors.push_back(r); }
+
+    for (int p : m_factors) {
+        m_max_factor = std::max(m_max_factor, p);
+    }
+
+    m_twiddle.resize(n);
+    for (int j = 0; j < n; ++j) {
+        double theta = -2.0 * Math::pi<double>() * double(j) / double(n);
+        m_twiddle[j] = value_type(Real(std::cos(theta)), Real(std::sin(theta)));
+    }
+}
+
+void
+Plan1D::forward (value_type* data, value_type* work) const
+{
+    transform(data, work, false);
+}
+
+void
+Plan1D::backward (value_type* data, value_type* work) const
+{
+    transform(data, work, true);
+}
+
+void
+Plan1D::transform (value_type* data, value_type* work, bool inverse) const
+{
+    if (m_n == 1) { return; }
+    std::copy(data, data+m_n, work);
+    recurse(work, 1, data, m_n, 0, inverse, work+m_n);
+}
+
+void
+Plan1D::recurse (value_type const* in, int stride, value_type* out, int n,
+                 int ifac, bool inverse, value_type* tmp) const
+{
+    if (n == 1) {
+        out[0] = in[0];
+        return;
+    }
+
+    const int p = m_factors[ifac];
+    const int m = n / p;
+
+    // Transform the p interleaved subsequences of length m.
+    for (int r = 0; r < p; ++r) {
+        recurse(in+r*stride, stride*p, out+r*m, m, ifac+1, inverse, tmp);
+    }
+
+    auto tw = [&] (int e) -> value_type
+    {
+        return inverse ? std::conj(m_twiddle[e]) : m_twiddle[e];
+    };
+
+    // Combine: X[k+q*m] = sum_r W_n^{r*(k+q*m)} Y_r[k]
+    const int tw_stride = m_n / n;
+    if (p == 2) {
+        for (int k = 0; k < m; ++k) {
+            value_type a = out[k];
+            value_type b = out[k+m] * tw(k*tw_stride);
+            out[k] = a + b;
+            out[k+m] = a - b;
+        }
+    } else if (p == 4) {
+        const value_type mi = inverse ? value_type(0,1) : value_type(0,-1);
+        for (int k = 0; k < m; ++k) {
+            value_type a0 = out[k];
+            value_type a1 = out[k+  m] * tw(  k*tw_stride);
+            value_type a2 = out[k+2*m] * tw(2*k*tw_stride);
+            value_type a3 = out[k+3*m] * tw(3*k*tw_stride);
+            value_type s02 = a0 + a2;
+            value_type d02 = a0 - a2;
+            value_type s13 = a1 + a3;
+            value_type d13 = (a1 - a3) * mi;
+            out[k    ] = s02 + s13;
+            out[k+  m] = d02 + d13;
+            out[k+2*m] = s02 - s13;
+            out[k+3*m] = d02 - d13;
+        }
+    } else if (p == 3) {
+        // sin(2 pi/3) times -i (forward) or i (backward)
+        const Real s60 = Real(0.86602540378443864676);
+        const value_type ms = inverse ? value_type(0,s60) : value_type(0,-s60);
+        for (int k = 0; k < m; ++k) {
+            value_type a0 = out[k];
+            value_type a1 = out[k+  m] * tw(  k*tw_stride);
+            value_type a2 = out[k+2*m] * tw(2*k*tw_stride);
+            value_type s12 = a1 + a2;
+            value_type t = a0 - Real(0.5)*s12;
+            value_type d12 = (a1 - a2) * ms;
+            out[k    ] = a0 + s12;
+            out[k+  m] = t + d12;
+            out[k+2*m] = t - d12;
+        }
+    } else if (p == 5) {
+        // cos and sin of 2 pi/5 and 4 pi/5
+        const Real c1 = Real( 0.30901699437494742410);
+        const Real c2 = Real(-0.80901699437494742410);
+        const Real s1 = Real( 0.95105651629515357212);
+        const Real s2 = Real( 0.58778525229247312917);
+        const value_type mi = inverse ? value_type(0,1) : value_type(0,-1);
+        for (int k = 0; k < m; ++k) {
+            value_type a0 = out[k];
+            value_type a1 = out[k+  m] * tw(  k*tw_stride);
+            value_type a2 = out[k+2*m] * tw(2*k*tw_stride);
+            value_type a3 = out[k+3*m] * tw(3*k*tw_stride);
+            value_type a4 = out[k+4*m] * tw(4*k*tw_stride);
+            value_type s14 = a1 + a4;
+            value_type s23 = a2 + a3;
+            value_type d14 = a1 - a4;
+            value_type d23 = a2 - a3;
+            value_type t1 = a0 + c1*s14 + c2*s23;
+            value_type t2 = a0 + c2*s14 + c1*s23;
+            value_type u1 = (s1*d14 + s2*d23) * mi;
+            value_type u2 = (s2*d14 - s1*d23) * mi;
+            out[k    ] = a0 + s14 + s23;
+            out[k+  m] = t1 + u1;
+            out[k+2*m] = t2 + u2;
+            out[k+3*m] = t2 - u2;
+            out[k+4*m] = t1 - u1;
+        }
+    } else {
+        const int tw_p = m_n / p;
+        value_type* y = tmp;
+        value_type* z = tmp + p;
+        for (int k = 0; k < m; ++k) {
+            for (int r = 0; r < p; ++r) {
+                y[r] = out[k+r*m] * tw(r*k*tw_stride);
+            }
+            for (int q = 0; q < p; ++q) {
+                value_type s = y[0];
+                for (int r = 1; r < p; ++r) {
+                    s += y[r] * tw(((r*q) % p) * tw_p);
+                }
+                z[q] = s;
+            }
+            for (int q = 0; q < p; ++q) {
+                out[k+q*m] = z[q];
+            }
+        }
+    }
+}
+
+}
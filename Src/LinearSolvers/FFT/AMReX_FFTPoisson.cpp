@@ -0,0 +1,359 @@
+#include <AMReX_FFTPoisson.H>
+#include <AMReX_Loop.H>
+#include <AMReX_Math.H>
+#include <AMReX_ParallelContext.H>
+#include <AMReX_Print.H>
+
+#include <cmath>
+
+namespace amrex
+{
+
+namespace {
+
+// Boxes that are long in direction dir and split in the other directions
+// so that there are at least as many boxes as processes, if possible.
+BoxArray make_pencils (Box const& domain, int dir)
+{
+    BoxList bl(domain);
+    IntVect chunk = domain.length();
+    while (bl.size() < ParallelContext::NProcsSub()) {
+        IntVect chunk_prev = chunk;
+        for (int jdim = AMREX_SPACEDIM-1; jdim >= 0; --jdim) {
+            if (jdim != dir) {
+                int new_chunk_size = chunk[jdim] / 2;
+                if (bl.size() < ParallelContext::NProcsSub()
+                    && new_chunk_size > 0) {
+                    chunk[jdim] = new_chunk_size;
+                    bl.maxSize(chunk);
+                }
+            }
+        }
+        if (chunk == chunk_prev) { break; }
+    }
+    return BoxArray(std::move(bl));
+}
+
+#if (AMREX_SPACEDIM == 3)
+// Antiderivative of 1/r with respect to x, y and z
+Real integral_inv_r (Real x, Real y, Real z)
+{
+    Real r = std::sqrt(x*x+y*y+z*z);
+    Real s = 0;
+    if (y*z != 0) { s += y*z*std::log(x+r); }
+    if (x*z != 0) { s += x*z*std::log(y+r); }
+    if (x*y != 0) { s += x*y*std::log(z+r); }
+    if (x != 0) { s -= Real(0.5)*x*x*std::atan(y*z/(x*r)); }
+    if (y != 0) { s -= Real(0.5)*y*y*std::atan(x*z/(y*r)); }
+    if (z != 0) { s -= Real(0.5)*z*z*std::atan(x*y/(z*r)); }
+    return s;
+}
+#elif (AMREX_SPACEDIM == 2)
+// Antiderivative of ln(r) with respect to x and y
+Real integral_log_r (Real x, Real y)
+{
+    Real s = 0;
+    if (x*y != 0) { s += x*y*(Real(0.5)*std::log(x*x+y*y) - Real(1.5)); }
+    if (x != 0) { s += Real(0.5)*x*x*std::atan(y/x); }
+    if (y != 0) { s += Real(0.5)*y*y*std::atan(x/y); }
+    return s;
+}
+#endif
+
+}
+
+FFTPoisson::FFTPoisson (const Geometry& a_geom,
+                        const BoxArray& a_grids,
+                        const DistributionMapping& a_dmap,
+                        BC a_bc)
+{
+    define(a_geom, a_grids, a_dmap, a_bc);
+}
+
+void FFTPoisson::define (const Geometry& a_geom,
+                         const BoxArray& a_grids,
+                         const DistributionMapping& a_dmap,
+                         BC a_bc)
+{
+    BL_PROFILE("FFTPoisson::define()");
+
+    AMREX_ALWAYS_ASSERT(a_grids.ixType().cellCentered());
+
+    m_geom = a_geom;
+    m_grids = a_grids;
+    m_dmap = a_dmap;
+    m_bc = a_bc;
+
+    Box const& domain = m_geom.Domain();
+    m_nonzero = domain;
+    if (m_bc == BC::periodic) {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_geom.isAllPeriodic() && m_geom.IsCartesian(),
+                                         "FFTPoisson: periodic BC requires all periodic Cartesian Geometry");
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_grids.numPts() == domain.numPts(),
+                                         "FFTPoisson: periodic BC requires BoxArray to cover the domain");
+        m_fft_domain = domain;
+    } else {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_geom.IsCartesian(),
+                                         "FFTPoisson: open BC requires Cartesian Geometry");
+        m_fft_domain = Box(domain.smallEnd(), domain.bigEnd() + domain.length());
+    }
+
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        BoxArray ba = make_pencils(m_fft_domain, idim);
+        DistributionMapping dm(ba);
+        m_pencil[idim].define(ba, dm, 2, 0, MFInfo().SetArena(The_Pinned_Arena()));
+        m_plan[idim] = std::make_unique<FFT::Plan1D>(m_fft_domain.length(idim));
+    }
+
+    if (m_bc == BC::open) {
+        computeGreensFunction();
+    } else {
+        m_green.clear();
+    }
+}
+
+void FFTPoisson::solve (MultiFab& a_sol, MultiFab const& a_rhs)
+{
+    BL_PROFILE("FFTPoisson::solve()");
+
+    if (m_verbose > 0) {
+        amrex::Print() << "FFTPoisson: FFT domain " << m_fft_domain
+                       << ", number of pencils " << m_pencil[0].size() << "\n";
+    }
+
+    AMREX_ASSERT(a_sol.boxArray() == m_grids && a_sol.DistributionMap() == m_dmap);
+    AMREX_ASSERT(a_rhs.boxArray() == m_grids && a_rhs.DistributionMap() == m_dmap);
+
+    auto& p0 = m_pencil[0];
+    p0.setVal(Real(0.0));
+    p0.ParallelCopy(a_rhs, 0, 0, 1);
+
+    forwardTransform(m_nonzero);
+
+    if (m_bc == BC::periodic) {
+        multiplyPeriodic();
+    } else {
+        multiplyOpen();
+    }
+
+    backwardTransform(m_nonzero);
+
+    a_sol.ParallelCopy(p0, 0, 0, 1);
+}
+
+void FFTPoisson::forwardTransform (Box const& active)
+{
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        if (idim > 0) {
+            m_pencil[idim].ParallelCopy(m_pencil[idim-1], 0, 0, 2);
+        }
+        fftPass(idim, false, active);
+    }
+}
+
+void FFTPoisson::backwardTransform (Box const& active)
+{
+    for (int idim = AMREX_SPACEDIM-1; idim >= 0; --idim) {
+        if (idim < AMREX_SPACEDIM-1) {
+            m_pencil[idim].ParallelCopy(m_pencil[idim+1], 0, 0, 2);
+        }
+        fftPass(idim, true, active);
+    }
+}
+
+// Transform all lines in direction dir.  Lines whose indices in the
+// directions after dir are outside of active are skipped; in the forward
+// direction they contain zeros, and in the backward direction their results
+// are not needed.
+void FFTPoisson::fftPass (int dir, bool inverse, Box const& active)
+{
+    BL_PROFILE("FFTPoisson::fftPass()");
+
+    Gpu::streamSynchronize();
+
+    Box lines_box = m_fft_domain;
+    for (int jdim = dir+1; jdim < AMREX_SPACEDIM; ++jdim) {
+        lines_box.setRange(jdim, active.smallEnd(jdim), active.length(jdim));
+    }
+
+    auto const& plan = *m_plan[dir];
+    const int n = plan.size();
+    auto& mf = m_pencil[dir];
+
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        Box lines = mfi.validbox() & lines_box;
+        if (!lines.ok()) { continue; }
+        const int lo = lines.smallEnd(dir);
+        lines.setBig(dir, lo);
+        const Long nlines = lines.numPts();
+        auto const& a = mf.array(mfi);
+#ifdef AMREX_USE_OMP
+#pragma omp parallel
+#endif
+        {
+            Vector<FFT::Plan1D::value_type> line(n);
+            Vector<FFT::Plan1D::value_type> work(plan.workSize());
+#ifdef AMREX_USE_OMP
+#pragma omp for
+#endif
+            for (Long iline = 0; iline < nlines; ++iline) {
+                IntVect iv = lines.atOffset(iline);
+                for (int m = 0; m < n; ++m) {
+                    iv[dir] = lo + m;
+                    line[m] = FFT::Plan1D::value_type(a(iv,0), a(iv,1));
+                }
+                if (inverse) {
+                    plan.backward(line.data(), work.data());
+                } else {
+                    plan.forward(line.data(), work.data());
+                }
+                for (int m = 0; m < n; ++m) {
+                    iv[dir] = lo + m;
+                    a(iv,0) = line[m].real();
+                    a(iv,1) = line[m].imag();
+                }
+            }
+        }
+    }
+}
+
+void FFTPoisson::multiplyPeriodic ()
+{
+    const auto dxinv = m_geom.InvCellSizeArray();
+    const auto dlo = amrex::lbound(m_fft_domain);
+    const Real fac = Real(1.0) / Real(m_fft_domain.d_numPts());
+
+    // Eigenvalues of the 1D second-order Laplacian
+    Array<Vector<Real>,AMREX_SPACEDIM> lambda;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        const int n = m_fft_domain.length(idim);
+        lambda[idim].resize(n);
+        for (int m = 0; m < n; ++m) {
+            lambda[idim][m] = (Real(2.0)*std::cos(Real(2.0)*Math::pi<Real>()*Real(m)/Real(n))
+                               - Real(2.0)) * dxinv[idim] * dxinv[idim];
+        }
+    }
+
+    auto& mf = m_pencil[AMREX_SPACEDIM-1];
+#ifdef AMREX_USE_OMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k) noexcept
+        {
+            amrex::ignore_unused(j,k,dlo);
+            Real lap = AMREX_D_TERM(lambda[0][i-dlo.x],
+                                    + lambda[1][j-dlo.y],
+                                    + lambda[2][k-dlo.z]);
+            Real s = (lap == Real(0.0)) ? Real(0.0) : fac / lap;
+            a(i,j,k,0) *= s;
+            a(i,j,k,1) *= s;
+        });
+    }
+}
+
+void FFTPoisson::multiplyOpen ()
+{
+    auto& mf = m_pencil[AMREX_SPACEDIM-1];
+#ifdef AMREX_USE_OMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        auto const& g = m_green.const_array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k) noexcept
+        {
+            a(i,j,k,0) *= g(i,j,k);
+            a(i,j,k,1) *= g(i,j,k);
+        });
+    }
+}
+
+// The convolution kernel is the Green's function at the cell distance times
+// the cell volume, except for the singular cell at zero distance, where the
+// Green's function integrated over the cell is used.
+void FFTPoisson::computeGreensFunction ()
+{
+    BL_PROFILE("FFTPoisson::computeGreensFunction()");
+
+    const auto dx = m_geom.CellSizeArray();
+    const auto dlo = amrex::lbound(m_fft_domain);
+    const auto nd = m_geom.Domain().length3d();
+    const Real dv = AMREX_D_TERM(dx[0], *dx[1], *dx[2]);
+
+#if (AMREX_SPACEDIM == 3)
+    Real g0 = 0;
+    {
+        const Real h[] = {Real(0.5)*dx[0], Real(0.5)*dx[1], Real(0.5)*dx[2]};
+        for (int kc = 0; kc < 2; ++kc) {
+        for (int jc = 0; jc < 2; ++jc) {
+        for (int ic = 0; ic < 2; ++ic) {
+            Real sgn = ((ic+jc+kc) % 2 == 0) ? Real(-1.0) : Real(1.0);
+            g0 += sgn * integral_inv_r(ic*h[0], jc*h[1], kc*h[2]);
+        }}}
+        g0 *= Real(-8.0) / (Real(4.0)*Math::pi<Real>());
+    }
+#elif (AMREX_SPACEDIM == 2)
+    const Real g0 = Real(4.0) * integral_log_r(Real(0.5)*dx[0], Real(0.5)*dx[1])
+        / (Real(2.0)*Math::pi<Real>());
+#else
+    const Real g0 = dx[0]*dx[0] / Real(8.0);
+#endif
+
+    auto& p0 = m_pencil[0];
+#ifdef AMREX_USE_OMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(p0); mfi.isValid(); ++mfi) {
+        auto const& a = p0.array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k) noexcept
+        {
+            int ii = i - dlo.x;
+            int jj = j - dlo.y;
+            int kk = k - dlo.z;
+            if (ii >= nd[0]) { ii -= 2*nd[0]; }
+            if (jj >= nd[1]) { jj -= 2*nd[1]; }
+            if (kk >= nd[2]) { kk -= 2*nd[2]; }
+            amrex::ignore_unused(jj,kk);
+            Real g;
+            if (ii == 0 && jj == 0 && kk == 0) {
+                g = g0;
+            } else {
+                Real r2 = AMREX_D_TERM(Real(ii*ii)*dx[0]*dx[0],
+                                       + Real(jj*jj)*dx[1]*dx[1],
+                                       + Real(kk*kk)*dx[2]*dx[2]);
+#if (AMREX_SPACEDIM == 3)
+                g = Real(-1.0) / (Real(4.0)*Math::pi<Real>()*std::sqrt(r2)) * dv;
+#elif (AMREX_SPACEDIM == 2)
+                g = std::log(r2) / (Real(4.0)*Math::pi<Real>()) * dv;
+#else
+                g = Real(0.5) * std::sqrt(r2) * dv;
+#endif
+            }
+            a(i,j,k,0) = g;
+            a(i,j,k,1) = Real(0.0);
+        });
+    }
+
+    forwardTransform(m_fft_domain);
+
+    // The kernel is even, so its transform is real.
+    auto const& pz = m_pencil[AMREX_SPACEDIM-1];
+    m_green.define(pz.boxArray(), pz.DistributionMap(), 1, 0,
+                   MFInfo().SetArena(The_Pinned_Arena()));
+    const Real fac = Real(1.0) / Real(m_fft_domain.d_numPts());
+#ifdef AMREX_USE_OMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(m_green); mfi.isValid(); ++mfi) {
+        auto const& g = m_green.array(mfi);
+        auto const& a = pz.const_array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k) noexcept
+        {
+            g(i,j,k) = a(i,j,k,0) * fac;
+        });
+    }
+}
+
+}
@@ -194,6 +194,8 @@ MLEBTensorOp::prepareForSolve ()
     }
 
     MLEBABecLap::prepareForSolve();
+
+    m_needs_update = false;
 }
 
 void
@@ -397,6 +397,8 @@ MLNodeLaplacian::setSigma (int amrlev, const MultiFab& a_sigma)
     } else {
         MultiFab::Copy(*m_sigma[amrlev][0][0], a_sigma, 0, 0, 1, 0);
     }
+
+    m_needs_update = true;
 }
 
 void
@@ -464,6 +466,22 @@ MLNodeLaplacian::prepareForSolve ()
 #endif
 
     buildStencil();
+
+    m_needs_update = false;
+}
+
+void
+MLNodeLaplacian::update ()
+{
+    BL_PROFILE("MLNodeLaplacian::update()");
+
+    // The masks and the EB integrals only depend on the grids and the
+    // geometry.  Only the coefficients and the stencils need to be rebuilt.
+    averageDownCoeffs();
+
+    buildStencil();
+
+    m_needs_update = false;
 }
 
 void
@@ -508,6 +508,25 @@ MLNodeLinOp::normInf (int amrlev, MultiFab const& mf, bool local) const
     }
 }
 
+Vector<Real>
+MLNodeLinOp::normInfComp (int amrlev, MultiFab const& mf, bool local) const
+{
+    const int ncomp = this->getNComp();
+    const int finest_level = NAMRLevels() - 1;
+    Vector<Real> norm(ncomp);
+    for (int n = 0; n < ncomp; ++n) {
+        if (amrlev == finest_level) {
+            norm[n] = mf.norminf(n, 1, IntVect(0), true);
+        } else {
+            norm[n] = mf.norminf(*m_norm_fine_mask[amrlev], n, 1, IntVect(0), true);
+        }
+    }
+    if (!local) {
+        ParallelAllReduce::Max(norm.data(), ncomp, ParallelContext::CommunicatorSub());
+    }
+    return norm;
+}
+
 void
 MLNodeLinOp::interpolationAmr (int famrlev, MultiFab& fine, const MultiFab& crse,
                                IntVect const& nghost) const
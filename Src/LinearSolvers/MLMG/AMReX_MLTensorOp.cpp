@@ -194,6 +194,8 @@ MLTensorOp::prepareForSolve ()
             }
         }
     }
+
+    m_needs_update = false;
 }
 
 void
@@ -205,10 +207,12 @@ MLTensorOp::apply (int amrlev, int mglev, MultiFab& out, MultiFab& in, BCMode bc
 #else
     BL_PROFILE("MLTensorOp::apply()");
 
-    MLABecLaplacian::apply(amrlev, mglev, out, in, bc_mode, s_mode, bndry);
-
-    if (mglev >= m_kappa[amrlev].size()) { return; }
+    if (mglev >= m_kappa[amrlev].size()) {
+        MLABecLaplacian::apply(amrlev, mglev, out, in, bc_mode, s_mode, bndry);
+        return;
+    }
 
+    applyBC(amrlev, mglev, in, bc_mode, s_mode, bndry);
     applyBCTensor(amrlev, mglev, in, bc_mode, s_mode, bndry);
 
     const auto& bcondloc = *m_bcondloc[amrlev][mglev];
@@ -220,10 +224,102 @@ MLTensorOp::apply (int amrlev, int mglev, MultiFab& out, MultiFab& in, BCMode bc
     const auto dlo = amrex::lbound(domain);
     const auto dhi = amrex::ubound(domain);
 
+    MultiFab const& acoefmf = m_a_coeffs[amrlev][mglev];
     Array<MultiFab,AMREX_SPACEDIM> const& etamf = m_b_coeffs[amrlev][mglev];
     Array<MultiFab,AMREX_SPACEDIM> const& kapmf = m_kappa[amrlev][mglev];
+    Real ascalar = m_a_scalar;
     Real bscalar = m_b_scalar;
 
+    const bool has_overset = m_overset_mask[amrlev][mglev] != nullptr;
+
+    // Boxes away from physical boundaries are done in a single pass that
+    // computes the scalar ABec part and the cross terms together without
+    // storing the face fluxes.  Other boxes, and all of them with an overset
+    // mask, only get the ABec part here and their cross terms below.
+#ifdef AMREX_USE_GPU
+    if (Gpu::inLaunchRegion()) {
+        const auto& xma = in.const_arrays();
+        const auto& yma = out.arrays();
+        const auto& ama = acoefmf.const_arrays();
+        AMREX_D_TERM(const auto& bxma = etamf[0].const_arrays();,
+                     const auto& byma = etamf[1].const_arrays();,
+                     const auto& bzma = etamf[2].const_arrays(););
+        if (has_overset) {
+            const auto& osmma = m_overset_mask[amrlev][mglev]->const_arrays();
+            ParallelFor(out, IntVect(0), AMREX_SPACEDIM,
+            [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k, int n) noexcept
+            {
+                mlabeclap_adotx_os(i,j,k,n, yma[box_no], xma[box_no], ama[box_no],
+                                   AMREX_D_DECL(bxma[box_no],byma[box_no],bzma[box_no]),
+                                   osmma[box_no], dxinv, ascalar, bscalar);
+            });
+        } else {
+            AMREX_D_TERM(const auto& kxma = kapmf[0].const_arrays();,
+                         const auto& kyma = kapmf[1].const_arrays();,
+                         const auto& kzma = kapmf[2].const_arrays(););
+            const IntVect ng = out.nGrowVect();
+            ParallelFor(out,
+            [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k) noexcept
+            {
+                if (domain.strictly_contains(amrex::grow(Box(yma[box_no]), -ng))) {
+                    mltensor_adotx(i,j,k, yma[box_no], xma[box_no], ama[box_no],
+                                   AMREX_D_DECL(bxma[box_no],byma[box_no],bzma[box_no]),
+                                   AMREX_D_DECL(kxma[box_no],kyma[box_no],kzma[box_no]),
+                                   dxinv, ascalar, bscalar);
+                } else {
+                    for (int n = 0; n < AMREX_SPACEDIM; ++n) {
+                        mlabeclap_adotx(i,j,k,n, yma[box_no], xma[box_no], ama[box_no],
+                                        AMREX_D_DECL(bxma[box_no],byma[box_no],bzma[box_no]),
+                                        dxinv, ascalar, bscalar);
+                    }
+                }
+            });
+        }
+    } else
+#endif
+    {
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(out, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            Array4<Real> const axfab = out.array(mfi);
+            Array4<Real const> const vfab = in.const_array(mfi);
+            Array4<Real const> const afab = acoefmf.const_array(mfi);
+            AMREX_D_TERM(Array4<Real const> const etaxfab = etamf[0].const_array(mfi);,
+                         Array4<Real const> const etayfab = etamf[1].const_array(mfi);,
+                         Array4<Real const> const etazfab = etamf[2].const_array(mfi););
+            if (has_overset) {
+                const auto& osm = m_overset_mask[amrlev][mglev]->const_array(mfi);
+                AMREX_HOST_DEVICE_PARALLEL_FOR_4D(bx, AMREX_SPACEDIM, i, j, k, n,
+                {
+                    mlabeclap_adotx_os(i,j,k,n, axfab, vfab, afab,
+                                       AMREX_D_DECL(etaxfab,etayfab,etazfab),
+                                       osm, dxinv, ascalar, bscalar);
+                });
+            } else if (domain.strictly_contains(bx)) {
+                AMREX_D_TERM(Array4<Real const> const kapxfab = kapmf[0].const_array(mfi);,
+                             Array4<Real const> const kapyfab = kapmf[1].const_array(mfi);,
+                             Array4<Real const> const kapzfab = kapmf[2].const_array(mfi););
+                AMREX_HOST_DEVICE_PARALLEL_FOR_3D(bx, i, j, k,
+                {
+                    mltensor_adotx(i,j,k, axfab, vfab, afab,
+                                   AMREX_D_DECL(etaxfab,etayfab,etazfab),
+                                   AMREX_D_DECL(kapxfab,kapyfab,kapzfab),
+                                   dxinv, ascalar, bscalar);
+                });
+            } else {
+                AMREX_HOST_DEVICE_PARALLEL_FOR_4D(bx, AMREX_SPACEDIM, i, j, k, n,
+                {
+                    mlabeclap_adotx(i,j,k,n, axfab, vfab, afab,
+                                    AMREX_D_DECL(etaxfab,etayfab,etazfab),
+                                    dxinv, ascalar, bscalar);
+                });
+            }
+        }
+    }
+
 #ifdef AMREX_USE_OMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
@@ -232,6 +328,8 @@ MLTensorOp::apply (int amrlev, int mglev, MultiFab& out, MultiFab& in, BCMode bc
         for (MFIter mfi(out, TilingIfNotGPU()); mfi.isValid(); ++mfi)
         {
             const Box& bx = mfi.tilebox();
+            if (domain.strictly_contains(bx) && !has_overset) { continue; }
+
             Array4<Real> const axfab = out.array(mfi);
             Array4<Real const> const vfab = in.const_array(mfi);
             AMREX_D_TERM(Array4<Real const> const etaxfab = etamf[0].const_array(mfi);,
@@ -240,6 +338,7 @@ MLTensorOp::apply (int amrlev, int mglev, MultiFab& out, MultiFab& in, BCMode bc
             AMREX_D_TERM(Array4<Real const> const kapxfab = kapmf[0].const_array(mfi);,
                          Array4<Real const> const kapyfab = kapmf[1].const_array(mfi);,
                          Array4<Real const> const kapzfab = kapmf[2].const_array(mfi););
+
             AMREX_D_TERM(Box const xbx = amrex::surroundingNodes(bx,0);,
                          Box const ybx = amrex::surroundingNodes(bx,1);,
                          Box const zbx = amrex::surroundingNodes(bx,2););
@@ -313,7 +412,7 @@ MLTensorOp::apply (int amrlev, int mglev, MultiFab& out, MultiFab& in, BCMode bc
                 );
             }
 
-            if (m_overset_mask[amrlev][mglev]) {
+            if (has_overset) {
                 const auto& osm = m_overset_mask[amrlev][mglev]->array(mfi);
                 AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( bx, tbx,
                 {
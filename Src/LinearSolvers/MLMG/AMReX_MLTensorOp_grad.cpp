@@ -48,6 +48,25 @@ MLTensorOp::compFlux (int amrlev, const Array<MultiFab*,AMREX_SPACEDIM>& fluxes,
             AMREX_D_TERM(Box const xbx = mfi.nodaltilebox(0);,
                          Box const ybx = mfi.nodaltilebox(1);,
                          Box const zbx = mfi.nodaltilebox(2););
+
+            if (domain.strictly_contains(mfi.tilebox())) {
+                // Add the cross terms straight into the output fluxes.
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    const Box& nbx = mfi.nodaltilebox(idim);
+                    Array4<Real      > dst = fluxes[idim]->array(mfi);
+                    Array4<Real const> eta = etamf[idim].const_array(mfi);
+                    Array4<Real const> kap = kapmf[idim].const_array(mfi);
+                    AMREX_HOST_DEVICE_PARALLEL_FOR_3D (nbx, i, j, k,
+                    {
+                        auto const f = mltensor_cross_flux(idim,i,j,k,vfab,eta,kap,dxinv);
+                        for (int n = 0; n < AMREX_SPACEDIM; ++n) {
+                            dst(i,j,k,n) += bscalar*f[n];
+                        }
+                    });
+                }
+                continue;
+            }
+
             AMREX_D_TERM(fluxfab_tmp[0].resize(xbx,AMREX_SPACEDIM);,
                          fluxfab_tmp[1].resize(ybx,AMREX_SPACEDIM);,
                          fluxfab_tmp[2].resize(zbx,AMREX_SPACEDIM););
@@ -58,59 +77,42 @@ MLTensorOp::compFlux (int amrlev, const Array<MultiFab*,AMREX_SPACEDIM>& fluxes,
                          Array4<Real> const fyfab = fluxfab_tmp[1].array();,
                          Array4<Real> const fzfab = fluxfab_tmp[2].array(););
 
-            if (domain.strictly_contains(mfi.tilebox())) {
-                AMREX_LAUNCH_HOST_DEVICE_LAMBDA_DIM
-                ( xbx, txbx,
-                  {
-                      mltensor_cross_terms_fx(txbx,fxfab,vfab,etaxfab,kapxfab,dxinv);
-                  }
-                , ybx, tybx,
-                  {
-                      mltensor_cross_terms_fy(tybx,fyfab,vfab,etayfab,kapyfab,dxinv);
-                  }
-                , zbx, tzbx,
-                  {
-                      mltensor_cross_terms_fz(tzbx,fzfab,vfab,etazfab,kapzfab,dxinv);
-                  }
-                );
-            } else {
-                const auto & bdcv = bcondloc.bndryConds(mfi);
-
-                Array2D<BoundCond,0,2*AMREX_SPACEDIM,0,AMREX_SPACEDIM> bct;
-                for (int icomp = 0; icomp < AMREX_SPACEDIM; ++icomp) {
-                    for (OrientationIter face; face; ++face) {
-                        Orientation ori = face();
-                        bct(ori,icomp) = bdcv[icomp][ori];
-                    }
+            const auto & bdcv = bcondloc.bndryConds(mfi);
+
+            Array2D<BoundCond,0,2*AMREX_SPACEDIM,0,AMREX_SPACEDIM> bct;
+            for (int icomp = 0; icomp < AMREX_SPACEDIM; ++icomp) {
+                for (OrientationIter face; face; ++face) {
+                    Orientation ori = face();
+                    bct(ori,icomp) = bdcv[icomp][ori];
                 }
+            }
 
-                const auto& bvxlo = (*bndry)[Orientation(0,Orientation::low )].array(mfi);
-                const auto& bvylo = (*bndry)[Orientation(1,Orientation::low )].array(mfi);
-                const auto& bvxhi = (*bndry)[Orientation(0,Orientation::high)].array(mfi);
-                const auto& bvyhi = (*bndry)[Orientation(1,Orientation::high)].array(mfi);
+            const auto& bvxlo = (*bndry)[Orientation(0,Orientation::low )].array(mfi);
+            const auto& bvylo = (*bndry)[Orientation(1,Orientation::low )].array(mfi);
+            const auto& bvxhi = (*bndry)[Orientation(0,Orientation::high)].array(mfi);
+            const auto& bvyhi = (*bndry)[Orientation(1,Orientation::high)].array(mfi);
 #if (AMREX_SPACEDIM == 3)
-                const auto& bvzlo = (*bndry)[Orientation(2,Orientation::low )].array(mfi);
-                const auto& bvzhi = (*bndry)[Orientation(2,Orientation::high)].array(mfi);
+            const auto& bvzlo = (*bndry)[Orientation(2,Orientation::low )].array(mfi);
+            const auto& bvzhi = (*bndry)[Orientation(2,Orientation::high)].array(mfi);
 #endif
 
-                AMREX_LAUNCH_HOST_DEVICE_LAMBDA_DIM
-                ( xbx, txbx,
-                  {
-                      mltensor_cross_terms_fx(txbx,fxfab,vfab,etaxfab,kapxfab,dxinv,
-                                              bvxlo, bvxhi, bct, dlo, dhi);
-                  }
-                , ybx, tybx,
-                  {
-                      mltensor_cross_terms_fy(tybx,fyfab,vfab,etayfab,kapyfab,dxinv,
-                                              bvylo, bvyhi, bct, dlo, dhi);
-                  }
-                , zbx, tzbx,
-                  {
-                      mltensor_cross_terms_fz(tzbx,fzfab,vfab,etazfab,kapzfab,dxinv,
-                                              bvzlo, bvzhi, bct, dlo, dhi);
-                  }
-                );
-            }
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA_DIM
+            ( xbx, txbx,
+              {
+                  mltensor_cross_terms_fx(txbx,fxfab,vfab,etaxfab,kapxfab,dxinv,
+                                          bvxlo, bvxhi, bct, dlo, dhi);
+              }
+            , ybx, tybx,
+              {
+                  mltensor_cross_terms_fy(tybx,fyfab,vfab,etayfab,kapyfab,dxinv,
+                                          bvylo, bvyhi, bct, dlo, dhi);
+              }
+            , zbx, tzbx,
+              {
+                  mltensor_cross_terms_fz(tzbx,fzfab,vfab,etazfab,kapzfab,dxinv,
+                                          bvzlo, bvzhi, bct, dlo, dhi);
+              }
+            );
 
             for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
                 const Box& nbx = mfi.nodaltilebox(idim);
@@ -1,5 +1,9 @@
 #include <AMReX_ParticleCommunication.H>
 #include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParallelReduce.H>
+
+#include <algorithm>
+#include <numeric>
 
 using namespace amrex;
 
@@ -70,28 +74,56 @@ void ParticleCopyPlan::buildMPIStart (const ParticleBufferMap& map, Long psize)
 
     std::map<int, Vector<int> > snd_data;
 
-    m_NumSnds = 0;
-    for (auto i : m_neighbor_procs)
+    auto count_sends = [&] () -> Long
     {
-        auto box_buffer_indices = map.allBucketsOnProc(i);
-        Long nbytes = 0;
-        for (auto bucket : box_buffer_indices)
+        Long num_particles = 0;
+        m_NumSnds = 0;
+        for (auto i : m_neighbor_procs)
         {
-            int dst = map.bucketToGrid(bucket);
-            int lev = map.bucketToLevel(bucket);
-            AMREX_ASSERT(m_box_counts_h[bucket] <= static_cast<unsigned int>(std::numeric_limits<int>::max()));
-            int npart = static_cast<int>(m_box_counts_h[bucket]);
-            if (npart == 0) { continue; }
-            m_snd_num_particles[i] += npart;
-            if (i == MyProc) { continue; }
-            snd_data[i].push_back(npart);
-            snd_data[i].push_back(dst);
-            snd_data[i].push_back(lev);
-            snd_data[i].push_back(MyProc);
-            nbytes += 4*sizeof(int);
+            auto box_buffer_indices = map.allBucketsOnProc(i);
+            Long nbytes = 0;
+            for (auto bucket : box_buffer_indices)
+            {
+                int dst = map.bucketToGrid(bucket);
+                int lev = map.bucketToLevel(bucket);
+                AMREX_ASSERT(m_box_counts_h[bucket] <= static_cast<unsigned int>(std::numeric_limits<int>::max()));
+                int npart = static_cast<int>(m_box_counts_h[bucket]);
+                if (npart == 0) { continue; }
+                m_snd_num_particles[i] += npart;
+                num_particles += npart;
+                if (i == MyProc) { continue; }
+                snd_data[i].push_back(npart);
+                snd_data[i].push_back(dst);
+                snd_data[i].push_back(lev);
+                snd_data[i].push_back(MyProc);
+                nbytes += 4*sizeof(int);
+            }
+            m_Snds[i] = nbytes;
+            m_NumSnds += nbytes;
+        }
+        return num_particles;
+    };
+
+    Long num_counted = count_sends();
+
+    if (m_sparse)
+    {
+        // If a particle goes beyond the neighbors, all procs switch to the global handshake.
+        Long num_particles = 0;
+        for (int bucket = 0; bucket < map.numBuckets(); ++bucket) {
+            num_particles += m_box_counts_h[bucket];
+        }
+        Long outside = (num_particles != num_counted) ? 1 : 0;
+        ParallelAllReduce::Max(outside, ParallelContext::CommunicatorSub());
+        if (outside) {
+            m_sparse = false;
+            m_neighbor_procs.resize(NProcs);
+            std::iota(m_neighbor_procs.begin(), m_neighbor_procs.end(), 0);
+            std::fill(m_Snds.begin(), m_Snds.end(), 0);
+            std::fill(m_snd_num_particles.begin(), m_snd_num_particles.end(), 0);
+            snd_data.clear();
+            count_sends();
         }
-        m_Snds[i] = nbytes;
-        m_NumSnds += nbytes;
     }
 
     doHandShake(m_Snds, m_Rcvs);
@@ -256,8 +288,8 @@ void ParticleCopyPlan::buildMPIFinish (const ParticleBufferMap& map) // NOLINT(r
 void ParticleCopyPlan::doHandShake (const Vector<Long>& Snds, Vector<Long>& Rcvs) const // NOLINT(readability-convert-member-functions-to-static)
 {
     BL_PROFILE("ParticleCopyPlan::doHandShake");
-    if (m_local) { doHandShakeLocal(Snds, Rcvs); }
-    else         { doHandShakeGlobal(Snds, Rcvs); }
+    if (m_local || m_sparse) { doHandShakeLocal(Snds, Rcvs); }
+    else                     { doHandShakeGlobal(Snds, Rcvs); }
 }
 
 void ParticleCopyPlan::doHandShakeLocal (const Vector<Long>& Snds, Vector<Long>& Rcvs) const // NOLINT(readability-convert-member-functions-to-static)
@@ -330,6 +362,16 @@ void ParticleCopyPlan::doHandShakeGlobal (const Vector<Long>& Snds, Vector<Long>
     const int SeqNum = ParallelDescriptor::SeqNum();
     const int NProcs = ParallelContext::NProcsSub();
 
+    // When no rank sends anything, which is common for incremental
+    // redistributes, a single reduction replaces the full handshake.
+    Long max_snds = 0;
+    for (int i = 0; i < NProcs; ++i) { max_snds = std::max(max_snds, Snds[i]); }
+    ParallelAllReduce::Max(max_snds, ParallelContext::CommunicatorSub());
+    if (max_snds == 0) {
+        std::fill(Rcvs.begin(), Rcvs.end(), 0);
+        return;
+    }
+
     Vector<Long> snd_connectivity(NProcs, 0);
     Vector<int > rcv_connectivity(NProcs, 1);
     for (int i = 0; i < NProcs; ++i) { if (Snds[i] > 0) { snd_connectivity[i] = 1; } }
@@ -380,3 +422,108 @@ void amrex::communicateParticlesFinish (const ParticleCopyPlan& plan)
     amrex::ignore_unused(plan);
 #endif
 }
+
+void PersistentParticleComm::define (const ParticleCopyPlan& plan, const char* snd_buffer, char* rcv_buffer)
+{
+    BL_PROFILE("PersistentParticleComm::define");
+
+    clear();
+    m_defined = true;
+    m_snd_buffer = snd_buffer;
+    m_rcv_buffer = rcv_buffer;
+
+#ifdef AMREX_USE_MPI
+    const int NProcs = ParallelContext::NProcsSub();
+    const int MyProc = ParallelContext::MyProcSub();
+    if (NProcs == 1) { return; }
+
+    // The same tag is used by every repetition.
+    const int SeqNum = ParallelDescriptor::SeqNum();
+    MPI_Comm comm = ParallelContext::CommunicatorSub();
+    const Long psize = plan.superParticleSize();
+
+    auto make_request = [&] (bool is_send, char* buf, Long nbytes, int who)
+    {
+        MPI_Request req;
+        const int comm_data_type = ParallelDescriptor::select_comm_data_type(nbytes);
+        MPI_Datatype dtype;
+        Long cnt;
+        if (comm_data_type == 1) {
+            dtype = ParallelDescriptor::Mpi_typemap<char>::type();
+            cnt = nbytes;
+        } else if (comm_data_type == 2) {
+            dtype = ParallelDescriptor::Mpi_typemap<unsigned long long>::type();
+            cnt = nbytes / Long(sizeof(unsigned long long));
+        } else {
+            amrex::Abort("PersistentParticleComm: message is too big");
+            return;
+        }
+        if (is_send) {
+            BL_MPI_REQUIRE( MPI_Send_init(buf, static_cast<int>(cnt), dtype, who, SeqNum, comm, &req) );
+        } else {
+            BL_MPI_REQUIRE( MPI_Recv_init(buf, static_cast<int>(cnt), dtype, who, SeqNum, comm, &req) );
+        }
+        m_requests.push_back(req);
+    };
+
+    // Same layout of the receive buffer as in communicateParticlesStart
+    Long TotRcvBytes = 0;
+    for (int i = 0; i < NProcs; ++i) {
+        if (plan.m_rcv_num_particles[i] > 0) {
+            Long nbytes = plan.m_rcv_num_particles[i]*psize;
+            std::size_t acd = ParallelDescriptor::sizeof_selected_comm_data_type(nbytes);
+            TotRcvBytes = Long(amrex::aligned_size(acd, TotRcvBytes));
+            make_request(false, rcv_buffer + TotRcvBytes, Long(amrex::aligned_size(acd, nbytes)), i);
+            TotRcvBytes += Long(amrex::aligned_size(acd, nbytes));
+        }
+    }
+
+    if (plan.m_NumSnds > 0) {
+        for (int i = 0; i < NProcs; ++i) {
+            if (i == MyProc) { continue; }
+            const auto Cnt = Long(plan.m_snd_counts[i]);
+            if (Cnt == 0) { continue; }
+            make_request(true, const_cast<char*>(snd_buffer) + plan.m_snd_offsets[i], Cnt, i); // NOLINT
+        }
+    }
+
+    m_stats.resize(m_requests.size());
+#else
+    amrex::ignore_unused(plan);
+#endif
+}
+
+void PersistentParticleComm::start ()
+{
+    AMREX_ASSERT(m_defined);
+#ifdef AMREX_USE_MPI
+    if (!m_requests.empty()) {
+        BL_MPI_REQUIRE( MPI_Startall(static_cast<int>(m_requests.size()), m_requests.data()) );
+    }
+#endif
+}
+
+void PersistentParticleComm::finish ()
+{
+    BL_PROFILE("PersistentParticleComm::finish");
+#ifdef AMREX_USE_MPI
+    if (!m_requests.empty()) {
+        BL_MPI_REQUIRE( MPI_Waitall(static_cast<int>(m_requests.size()), m_requests.data(),
+                                    m_stats.data()) );
+    }
+#endif
+}
+
+void PersistentParticleComm::clear ()
+{
+#ifdef AMREX_USE_MPI
+    for (auto& req : m_requests) {
+        if (req != MPI_REQUEST_NULL) { MPI_Request_free(&req); }
+    }
+#endif
+    m_requests.clear();
+    m_stats.clear();
+    m_defined = false;
+    m_snd_buffer = nullptr;
+    m_rcv_buffer = nullptr;
+}
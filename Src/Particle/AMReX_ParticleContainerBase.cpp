@@ -4,12 +4,17 @@
 #include <AMReX_ParmParse.H>
 #include <AMReX_ParallelDescriptor.H>
 #include <AMReX_iMultiFab.H>
+#include <AMReX_ParticleMPIUtil.H>
+
+#include <algorithm>
 
 using namespace amrex;
 
 bool    ParticleContainerBase::do_tiling = false;
 IntVect ParticleContainerBase::tile_size { AMREX_D_DECL(1024000,8,8) };
 bool    ParticleContainerBase::memEfficientSort = true;
+bool    ParticleContainerBase::sparse_redistribute = false;
+int     ParticleContainerBase::sparse_redistribute_ngrow = 1;
 
 void ParticleContainerBase::Define (const Geometry            & geom,
                                     const DistributionMapping & dmap,
@@ -328,3 +333,39 @@ void ParticleContainerBase::BuildRedistributeMask (int lev, int nghost) const
         RemoveDuplicates(neighbor_procs);
     }
 }
+
+const Vector<int>& ParticleContainerBase::RedistributeNeighborProcs () const
+{
+    const int nlevs = finestLevel() + 1;
+    bool valid = (m_sparse_neighbor_ngrow == sparse_redistribute_ngrow) &&
+                 (static_cast<int>(m_sparse_neighbor_ba.size()) == nlevs);
+    for (int lev = 0; valid && lev < nlevs; ++lev) {
+        valid = BoxArray::SameRefs(m_sparse_neighbor_ba[lev], ParticleBoxArray(lev)) &&
+                DistributionMapping::SameRefs(m_sparse_neighbor_dm[lev], ParticleDistributionMap(lev));
+    }
+
+    if (!valid)
+    {
+        BL_PROFILE("ParticleContainer::RedistributeNeighborProcs");
+
+        m_sparse_neighbor_ngrow = sparse_redistribute_ngrow;
+        m_sparse_neighbor_ba.resize(nlevs);
+        m_sparse_neighbor_dm.resize(nlevs);
+        for (int lev = 0; lev < nlevs; ++lev) {
+            m_sparse_neighbor_ba[lev] = ParticleBoxArray(lev);
+            m_sparse_neighbor_dm[lev] = ParticleDistributionMap(lev);
+        }
+
+        m_sparse_neighbor_procs = computeNeighborProcs(GetParGDB(), sparse_redistribute_ngrow);
+        const int MyProc = ParallelContext::MyProcSub();
+        m_sparse_neighbor_procs.erase(std::remove(m_sparse_neighbor_procs.begin(),
+                                                  m_sparse_neighbor_procs.end(), MyProc),
+                                      m_sparse_neighbor_procs.end());
+#ifdef AMREX_USE_MPI
+        // With several levels, computeNeighborProcs is not necessarily symmetric.
+        m_sparse_neighbor_procs = symmetrizeNeighborProcs(m_sparse_neighbor_procs);
+#endif
+    }
+
+    return m_sparse_neighbor_procs;
+}
@@ -4,6 +4,8 @@
 #include <AMReX_ParallelReduce.H>
 #include <AMReX_BLProfiler.H>
 
+#include <algorithm>
+
 namespace amrex {
 
 #ifdef AMREX_USE_MPI
@@ -92,6 +94,93 @@ namespace amrex {
 
         return NumSnds;
     }
+
+    Long doHandShakeSparse(const std::map<int, Vector<char> >& not_ours,
+                           const Vector<int>& neighbor_procs, Vector<Long>& Snds, Vector<Long>& Rcvs)
+    {
+        Long counts[2] = {0, 0}; // bytes to send, whether any goes outside the neighbors
+        for (const auto& kv : not_ours)
+        {
+            counts[0]     += kv.second.size();
+            Snds[kv.first] = kv.second.size();
+            if (!std::binary_search(neighbor_procs.begin(), neighbor_procs.end(), kv.first)) {
+                counts[1] = 1;
+            }
+        }
+
+        ParallelAllReduce::Max(counts, 2, ParallelContext::CommunicatorSub());
+
+        if (counts[0] == 0) { return 0; }
+
+        if (counts[1] == 0) {
+            doHandShakeLocal(not_ours, neighbor_procs, Snds, Rcvs);
+        } else {
+            BL_COMM_PROFILE(BLProfiler::Alltoall, sizeof(Long),
+                            ParallelContext::MyProcSub(), BLProfiler::BeforeCall());
+
+            BL_MPI_REQUIRE( MPI_Alltoall(Snds.dataPtr(),
+                                         1,
+                                         ParallelDescriptor::Mpi_typemap<Long>::type(),
+                                         Rcvs.dataPtr(),
+                                         1,
+                                         ParallelDescriptor::Mpi_typemap<Long>::type(),
+                                         ParallelContext::CommunicatorSub()) );
+
+            BL_COMM_PROFILE(BLProfiler::Alltoall, sizeof(Long),
+                            ParallelContext::MyProcSub(), BLProfiler::AfterCall());
+        }
+
+        return counts[0];
+    }
+
+    Vector<int> symmetrizeNeighborProcs(const Vector<int>& neighbor_procs)
+    {
+        BL_PROFILE("symmetrizeNeighborProcs()");
+
+        const int SeqNum = ParallelDescriptor::SeqNum();
+        MPI_Comm comm = ParallelContext::CommunicatorSub();
+
+        Vector<int> procs(neighbor_procs);
+
+        // Tell each neighbor about us with synchronous sends.  Once they have
+        // all been matched, we enter a barrier; when every proc has done so,
+        // all messages have been received.
+        const auto num_snds = static_cast<int>(neighbor_procs.size());
+        Vector<MPI_Request> sreqs(num_snds);
+        for (int i = 0; i < num_snds; ++i) {
+            BL_MPI_REQUIRE( MPI_Issend(nullptr, 0, MPI_INT, neighbor_procs[i], SeqNum,
+                                       comm, &sreqs[i]) );
+        }
+
+        MPI_Request barrier_req;
+        bool in_barrier = false;
+        while (true)
+        {
+            int flag = 0;
+            MPI_Status status;
+            BL_MPI_REQUIRE( MPI_Iprobe(MPI_ANY_SOURCE, SeqNum, comm, &flag, &status) );
+            if (flag) {
+                BL_MPI_REQUIRE( MPI_Recv(nullptr, 0, MPI_INT, status.MPI_SOURCE, SeqNum,
+                                         comm, MPI_STATUS_IGNORE) );
+                procs.push_back(status.MPI_SOURCE);
+            }
+
+            if (in_barrier) {
+                BL_MPI_REQUIRE( MPI_Test(&barrier_req, &flag, MPI_STATUS_IGNORE) );
+                if (flag) { break; }
+            } else {
+                BL_MPI_REQUIRE( MPI_Testall(num_snds, sreqs.dataPtr(), &flag,
+                                            MPI_STATUSES_IGNORE) );
+                if (flag) {
+                    BL_MPI_REQUIRE( MPI_Ibarrier(comm, &barrier_req) );
+                    in_barrier = true;
+                }
+            }
+        }
+
+        RemoveDuplicates(procs);
+        return procs;
+    }
 #endif  // AMREX_USE_MPI
 
 }
@@ -0,0 +1,433 @@
+#include <AMReX_ParticleTreeGravity.H>
+
+#include <AMReX_BLProfiler.H>
+#include <AMReX_MFIter.H>
+#include <AMReX_ParallelContext.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParallelReduce.H>
+#include <AMReX_Print.H>
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+
+namespace amrex {
+
+namespace {
+
+    //! Bits per dimension of the Morton keys of the tree, i.e. its maximum depth
+    constexpr int tree_bits = 63 / AMREX_SPACEDIM;
+
+    //! Maximum size of the stack of a tree walk
+    constexpr int tree_stack_size = tree_bits * ((1 << AMREX_SPACEDIM) - 1) + 1;
+
+    std::uint64_t mortonKey (std::array<std::uint64_t,AMREX_SPACEDIM> const& iv) noexcept
+    {
+        std::uint64_t key = 0;
+        for (int b = tree_bits-1; b >= 0; --b) {
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                key = (key << 1) | ((iv[d] >> b) & 1);
+            }
+        }
+        return key;
+    }
+
+    Real distanceSquared (RealVect const& x, RealBox const& rb) noexcept
+    {
+        Real r2 = 0;
+        for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+            Real dx = std::max({rb.lo(d)-x[d], Real(0), x[d]-rb.hi(d)});
+            r2 += dx*dx;
+        }
+        return r2;
+    }
+}
+
+void
+ParticleTreeGravity::build (Vector<ParticleReal> const& pos, Vector<ParticleReal> const& mass,
+                            Vector<RealBox> const& targets)
+{
+    BL_PROFILE("ParticleTreeGravity::build()");
+
+    AMREX_ALWAYS_ASSERT(pos.size() == mass.size()*AMREX_SPACEDIM);
+
+    const Real strt_time = amrex::second();
+
+    const int nlocal = static_cast<int>(mass.size());
+    m_pos.resize(nlocal);
+    m_mass.resize(nlocal);
+    for (int i = 0; i < nlocal; ++i) {
+        for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+            m_pos[i][d] = pos[std::size_t(i)*AMREX_SPACEDIM+d];
+        }
+        m_mass[i] = mass[i];
+    }
+    m_num_imported = 0;
+
+    buildTree();
+
+#ifdef AMREX_USE_MPI
+    const int nprocs = ParallelContext::NProcsSub();
+    const int myproc = ParallelContext::MyProcSub();
+    MPI_Comm comm = ParallelContext::CommunicatorSub();
+
+    if (nprocs > 1)
+    {
+        // Everybody learns the target regions of everybody else.
+        constexpr int box_size = 2*AMREX_SPACEDIM;
+        const auto mpi_real = ParallelDescriptor::Mpi_typemap<Real>::type();
+
+        int ntargets = static_cast<int>(targets.size());
+        Vector<int> all_ntargets(nprocs);
+        ParallelAllGather::AllGather(ntargets, all_ntargets.data(), comm);
+
+        Vector<int> box_counts(nprocs), box_offsets(nprocs+1, 0);
+        for (int i = 0; i < nprocs; ++i) {
+            box_counts[i] = all_ntargets[i]*box_size;
+            box_offsets[i+1] = box_offsets[i] + box_counts[i];
+        }
+
+        Vector<Real> snd_boxes;
+        snd_boxes.reserve(box_counts[myproc]);
+        for (auto const& rb : targets) {
+            snd_boxes.insert(snd_boxes.end(), rb.lo(), rb.lo()+AMREX_SPACEDIM);
+            snd_boxes.insert(snd_boxes.end(), rb.hi(), rb.hi()+AMREX_SPACEDIM);
+        }
+        Vector<Real> all_boxes(box_offsets[nprocs]);
+        BL_MPI_REQUIRE( MPI_Allgatherv(snd_boxes.data(), box_counts[myproc], mpi_real,
+                                       all_boxes.data(), box_counts.data(), box_offsets.data(),
+                                       mpi_real, comm) );
+
+        // Walk the local tree against the targets of each of the other processes.
+        Vector<Vector<ParticleReal>> snd_data(nprocs);
+        for (int i = 0; i < nprocs; ++i) {
+            if (i == myproc || all_ntargets[i] == 0) { continue; }
+            Vector<RealBox> their_targets(all_ntargets[i]);
+            for (int j = 0; j < all_ntargets[i]; ++j) {
+                Real const* p = all_boxes.data() + box_offsets[i] + j*box_size;
+                their_targets[j] = RealBox(p, p+AMREX_SPACEDIM);
+            }
+            exportTree(their_targets, snd_data[i]);
+        }
+
+        Vector<int> snd_counts(nprocs), rcv_counts(nprocs);
+        for (int i = 0; i < nprocs; ++i) {
+            snd_counts[i] = static_cast<int>(snd_data[i].size());
+        }
+        BL_MPI_REQUIRE( MPI_Alltoall(snd_counts.data(), 1, MPI_INT,
+                                     rcv_counts.data(), 1, MPI_INT, comm) );
+
+        Vector<int> snd_offsets(nprocs+1, 0), rcv_offsets(nprocs+1, 0);
+        for (int i = 0; i < nprocs; ++i) {
+            snd_offsets[i+1] = snd_offsets[i] + snd_counts[i];
+            rcv_offsets[i+1] = rcv_offsets[i] + rcv_counts[i];
+        }
+        Vector<ParticleReal> snd_buf(snd_offsets[nprocs]);
+        for (int i = 0; i < nprocs; ++i) {
+            std::copy(snd_data[i].begin(), snd_data[i].end(), snd_buf.begin()+snd_offsets[i]);
+        }
+        Vector<ParticleReal> rcv_buf(rcv_offsets[nprocs]);
+        const auto mpi_preal = ParallelDescriptor::Mpi_typemap<ParticleReal>::type();
+        BL_MPI_REQUIRE( MPI_Alltoallv(snd_buf.data(), snd_counts.data(), snd_offsets.data(), mpi_preal,
+                                      rcv_buf.data(), rcv_counts.data(), rcv_offsets.data(), mpi_preal,
+                                      comm) );
+
+        // Merge the imported sources into the tree.
+        constexpr int stride = AMREX_SPACEDIM + 1;
+        m_num_imported = rcv_offsets[nprocs] / stride;
+        m_pos.reserve(nlocal + m_num_imported);
+        m_mass.reserve(nlocal + m_num_imported);
+        for (int i = 0; i < m_num_imported; ++i) {
+            ParticleReal const* b = rcv_buf.data() + std::size_t(i)*stride;
+            RealVect x;
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) { x[d] = b[d]; }
+            m_pos.push_back(x);
+            m_mass.push_back(b[AMREX_SPACEDIM]);
+        }
+
+        buildTree();
+    }
+#else
+    amrex::ignore_unused(targets);
+#endif
+
+    if (m_verbose > 0) {
+        Long nsources = nlocal;
+        Long nimported = m_num_imported;
+        Real stop_time = amrex::second() - strt_time;
+        ParallelReduce::Sum(nsources, ParallelContext::IOProcessorNumberSub(),
+                            ParallelContext::CommunicatorSub());
+        ParallelReduce::Sum(nimported, ParallelContext::IOProcessorNumberSub(),
+                            ParallelContext::CommunicatorSub());
+        ParallelReduce::Max(stop_time, ParallelContext::IOProcessorNumberSub(),
+                            ParallelContext::CommunicatorSub());
+        amrex::Print() << "ParticleTreeGravity::build: " << nsources << " sources, "
+                       << nimported << " imported, time: " << stop_time << '\n';
+    }
+}
+
+void
+ParticleTreeGravity::buildTree ()
+{
+    BL_PROFILE("ParticleTreeGravity::buildTree()");
+
+    m_nodes.clear();
+
+    const int n = numSources();
+    if (n == 0) { return; }
+
+    // The root is the bounding cube of the sources.
+    RealVect lo = m_pos[0], hi = m_pos[0];
+    for (int i = 1; i < n; ++i) {
+        lo.min(m_pos[i]);
+        hi.max(m_pos[i]);
+    }
+    const RealVect extent = hi - lo;
+    Real root_size = extent[extent.maxDir(false)];
+    if (root_size <= Real(0)) { root_size = Real(1); }
+
+    const std::uint64_t maxcell = (std::uint64_t(1) << tree_bits) - 1;
+    const Real scale = Real(maxcell+1) / root_size;
+    Vector<std::uint64_t> keys(n);
+    for (int i = 0; i < n; ++i) {
+        std::array<std::uint64_t,AMREX_SPACEDIM> iv;
+        for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+            auto c = static_cast<std::uint64_t>((m_pos[i][d]-lo[d])*scale);
+            iv[d] = std::min(c, maxcell);
+        }
+        keys[i] = mortonKey(iv);
+    }
+
+    Vector<int> perm(n);
+    std::iota(perm.begin(), perm.end(), 0);
+    std::sort(perm.begin(), perm.end(), [&] (int a, int b) { return keys[a] < keys[b]; });
+    {
+        Vector<std::uint64_t> tmp_keys(n);
+        Vector<RealVect> tmp_pos(n);
+        Vector<Real> tmp_mass(n);
+        for (int i = 0; i < n; ++i) {
+            tmp_keys[i] = keys[perm[i]];
+            tmp_pos[i] = m_pos[perm[i]];
+            tmp_mass[i] = m_mass[perm[i]];
+        }
+        std::swap(keys, tmp_keys);
+        std::swap(m_pos, tmp_pos);
+        std::swap(m_mass, tmp_mass);
+    }
+
+    // Split the nodes breadth first, so that children come after their parents.
+    Node root;
+    root.lo = lo;
+    root.size = root_size;
+    root.begin = 0;
+    root.end = n;
+    m_nodes.push_back(root);
+
+    constexpr std::uint64_t child_mask = (1 << AMREX_SPACEDIM) - 1;
+    for (int inode = 0; inode < numNodes(); ++inode) {
+        const Node parent = m_nodes[inode];
+        if (parent.end - parent.begin <= m_leaf_size || parent.level == tree_bits) { continue; }
+        const int shift = AMREX_SPACEDIM*(tree_bits-1-parent.level);
+        const Real half = parent.size * Real(0.5);
+        m_nodes[inode].first_child = numNodes();
+        int i = parent.begin;
+        while (i < parent.end) {
+            const std::uint64_t c = (keys[i] >> shift) & child_mask;
+            int j = i+1;
+            while (j < parent.end && ((keys[j] >> shift) & child_mask) == c) { ++j; }
+            Node child;
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                const auto bit = (c >> (AMREX_SPACEDIM-1-d)) & 1;
+                child.lo[d] = parent.lo[d] + (bit ? half : Real(0));
+            }
+            child.size = half;
+            child.begin = i;
+            child.end = j;
+            child.level = parent.level + 1;
+            m_nodes.push_back(child);
+            ++m_nodes[inode].num_children;
+            i = j;
+        }
+    }
+
+    // Moments and opening radii, children first.
+    const Real inv_theta = (m_theta > Real(0)) ? Real(1)/m_theta : std::numeric_limits<Real>::max();
+    for (int inode = numNodes()-1; inode >= 0; --inode) {
+        Node& nd = m_nodes[inode];
+        Real m = 0;
+        RealVect mx(Real(0));
+        if (nd.num_children == 0) {
+            for (int i = nd.begin; i < nd.end; ++i) {
+                m += m_mass[i];
+                mx += m_mass[i]*m_pos[i];
+            }
+        } else {
+            for (int c = nd.first_child; c < nd.first_child+nd.num_children; ++c) {
+                m += m_nodes[c].mass;
+                mx += m_nodes[c].mass*m_nodes[c].com;
+            }
+        }
+        const RealVect center = nd.lo + Real(0.5)*nd.size;
+        nd.mass = m;
+        nd.com = (m != Real(0)) ? mx/m : center;
+        if (m_theta > Real(0)) {
+            const Real rcrit = nd.size*inv_theta + (nd.com - center).vectorLength();
+            nd.rcrit2 = rcrit*rcrit;
+        } else {
+            nd.rcrit2 = std::numeric_limits<Real>::max();
+        }
+    }
+}
+
+void
+ParticleTreeGravity::exportTree (Vector<RealBox> const& targets, Vector<ParticleReal>& buf) const
+{
+    buf.clear();
+    if (m_nodes.empty()) { return; }
+
+    auto push = [&] (RealVect const& x, Real m)
+    {
+        for (int d = 0; d < AMREX_SPACEDIM; ++d) { buf.push_back(ParticleReal(x[d])); }
+        buf.push_back(ParticleReal(m));
+    };
+
+    std::array<int,tree_stack_size> stack; // NOLINT(cppcoreguidelines-pro-type-member-init)
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        Node const& nd = m_nodes[stack[--top]];
+        Real r2 = std::numeric_limits<Real>::max();
+        for (auto const& rb : targets) {
+            r2 = std::min(r2, distanceSquared(nd.com, rb));
+        }
+        if (r2 > nd.rcrit2) {
+            push(nd.com, nd.mass);
+        } else if (nd.num_children == 0) {
+            for (int i = nd.begin; i < nd.end; ++i) { push(m_pos[i], m_mass[i]); }
+        } else {
+            for (int c = nd.first_child; c < nd.first_child+nd.num_children; ++c) {
+                stack[top++] = c;
+            }
+        }
+    }
+}
+
+void
+ParticleTreeGravity::evaluate (RealVect const& x, Real& phi, RealVect& acc) const noexcept
+{
+    Real p = 0;
+    RealVect a(Real(0));
+    const Real eps2 = m_eps*m_eps;
+
+    auto interact = [&] (RealVect const& y, Real m)
+    {
+        const RealVect dx = x - y;
+        const Real r2 = dx.radSquared() + eps2;
+        if (r2 > Real(0)) {
+            const Real rinv = Real(1)/std::sqrt(r2);
+            p -= m*rinv;
+            a -= (m*rinv*rinv*rinv)*dx;
+        }
+    };
+
+    if (!m_nodes.empty()) {
+        std::array<int,tree_stack_size> stack; // NOLINT(cppcoreguidelines-pro-type-member-init)
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            Node const& nd = m_nodes[stack[--top]];
+            if ((x - nd.com).radSquared() > nd.rcrit2) {
+                interact(nd.com, nd.mass);
+            } else if (nd.num_children == 0) {
+                for (int i = nd.begin; i < nd.end; ++i) { interact(m_pos[i], m_mass[i]); }
+            } else {
+                for (int c = nd.first_child; c < nd.first_child+nd.num_children; ++c) {
+                    stack[top++] = c;
+                }
+            }
+        }
+    }
+
+    phi = m_G*p;
+    acc = m_G*a;
+}
+
+Vector<RealBox>
+ParticleTreeGravity::boundaryTargets (MultiFab const& phi, Geometry const& geom)
+{
+    Vector<RealBox> r;
+    const Box& domain = geom.Domain();
+    const auto dx = geom.CellSizeArray();
+    const auto problo = geom.ProbLoArray();
+    for (MFIter mfi(phi); mfi.isValid(); ++mfi) {
+        const Box& fbx = mfi.fabbox();
+        for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+            if (geom.isPeriodic(dir)) { continue; }
+            for (const Box& face : {amrex::adjCellLo(domain,dir), amrex::adjCellHi(domain,dir)}) {
+                const Box b = face & fbx;
+                if (b.ok()) {
+                    RealBox rb(b, dx.data(), problo.data());
+                    const Real xface = (face.smallEnd(dir) < domain.smallEnd(dir))
+                        ? geom.ProbLo(dir) : geom.ProbHi(dir);
+                    rb.setLo(dir, xface);
+                    rb.setHi(dir, xface);
+                    r.push_back(rb);
+                }
+            }
+        }
+    }
+    return r;
+}
+
+void
+ParticleTreeGravity::fillDomainBoundary (MultiFab& phi, Geometry const& geom) const
+{
+    BL_PROFILE("ParticleTreeGravity::fillDomainBoundary()");
+
+    const Box& domain = geom.Domain();
+    const auto dx = geom.CellSizeArray();
+    const auto problo = geom.ProbLoArray();
+    for (MFIter mfi(phi); mfi.isValid(); ++mfi) {
+        const Box& fbx = mfi.fabbox();
+        auto const& a = phi.array(mfi);
+        for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+            if (geom.isPeriodic(dir)) { continue; }
+            for (const Box& face : {amrex::adjCellLo(domain,dir), amrex::adjCellHi(domain,dir)}) {
+                const Box b = face & fbx;
+                if (!b.ok()) { continue; }
+                const Real xface = (face.smallEnd(dir) < domain.smallEnd(dir))
+                    ? geom.ProbLo(dir) : geom.ProbHi(dir);
+
+                const auto lo = amrex::lbound(b);
+                const auto len = amrex::length(b);
+                const auto npts = static_cast<int>(b.numPts());
+                Gpu::HostVector<Real> h_val(npts);
+#ifdef AMREX_USE_OMP
+#pragma omp parallel for
+#endif
+                for (int n = 0; n < npts; ++n) {
+                    IntVect iv(AMREX_D_DECL(lo.x + n%len.x,
+                                            lo.y + (n/len.x)%len.y,
+                                            lo.z + n/(len.x*len.y)));
+                    RealVect x;
+                    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                        x[d] = (d == dir) ? xface : problo[d] + (iv[d]+Real(0.5))*dx[d];
+                    }
+                    h_val[n] = potential(x);
+                }
+
+                Gpu::DeviceVector<Real> d_val(npts);
+                Gpu::copyAsync(Gpu::hostToDevice, h_val.begin(), h_val.end(), d_val.begin());
+                Real const* AMREX_RESTRICT pval = d_val.dataPtr();
+                amrex::ParallelFor(b, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+                {
+                    a(i,j,k,0) = pval[(i-lo.x) + len.x*((j-lo.y) + len.y*(k-lo.z))];
+                });
+                Gpu::streamSynchronize();
+            }
+        }
+    }
+}
+
+}
@@ -0,0 +1,186 @@
+//
+// Builds the grids of the same tagging with the serial clustering on the
+// I/O process and with amr.distributed_clustering, where each process
+// clusters its own tags.  When all the tags of a level are on one process
+// (a single coarse grid, or a single process) the two must give the same
+// grids.  Otherwise the clusters are allowed to differ, and the test checks
+// that the distributed grids are disjoint, cover the tags and are properly
+// nested.
+//
+
+#include <AMReX.H>
+#include <AMReX_AmrMesh.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_TagBox.H>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace amrex;
+
+namespace {
+
+struct TestParams
+{
+    int n_cell = 64;
+    int max_grid_size = 16;
+    int max_level = 2;
+};
+
+// The tags are a spherical shell, which crosses the grids of many processes.
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+bool tagged (GpuArray<Real,AMREX_SPACEDIM> const& x) noexcept
+{
+    Real r2 = 0;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        r2 += (x[idim]-Real(0.45))*(x[idim]-Real(0.45));
+    }
+    return std::abs(std::sqrt(r2) - Real(0.3)) < Real(0.05);
+}
+
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+GpuArray<Real,AMREX_SPACEDIM> cell_center (IntVect const& iv, GpuArray<Real,AMREX_SPACEDIM> const& problo,
+                                           GpuArray<Real,AMREX_SPACEDIM> const& dx) noexcept
+{
+    GpuArray<Real,AMREX_SPACEDIM> x;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        x[idim] = problo[idim] + (Real(iv[idim])+Real(0.5))*dx[idim];
+    }
+    return x;
+}
+
+class TagMesh
+    :
+    public AmrMesh
+{
+public:
+    using AmrMesh::AmrMesh;
+
+    void ErrorEst (int lev, TagBoxArray& tags, Real /*time*/, int /*ngrow*/) override
+    {
+        const auto problo = Geom(lev).ProbLoArray();
+        const auto dx = Geom(lev).CellSizeArray();
+        auto const& ta = tags.arrays();
+        amrex::ParallelFor(tags, [=] AMREX_GPU_DEVICE (int b, int i, int j, int k) noexcept
+        {
+            if (tagged(cell_center(IntVect(AMREX_D_DECL(i,j,k)), problo, dx))) {
+                ta[b](i,j,k) = TagBox::SET;
+            }
+        });
+        Gpu::streamSynchronize();
+    }
+};
+
+Vector<BoxArray> make_grids (Geometry const& geom, AmrInfo info, bool distributed)
+{
+    info.use_distributed_clustering = distributed;
+    TagMesh mesh(geom, info);
+    mesh.MakeNewGrids(Real(0.0));
+    Vector<BoxArray> grids;
+    for (int lev = 0; lev <= mesh.finestLevel(); ++lev) {
+        grids.push_back(mesh.boxArray(lev));
+    }
+    return grids;
+}
+
+// Checks the properties that do not depend on how the tags are clustered.
+void check_grids (Vector<BoxArray> const& grids, Geometry const& geom, AmrInfo const& info)
+{
+    AMREX_ALWAYS_ASSERT(static_cast<int>(grids.size()) == info.max_level+1);
+
+    Geometry lgeom = geom;
+    for (int lev = 1; lev < static_cast<int>(grids.size()); ++lev) {
+        BoxArray const& fba = grids[lev];
+        BoxArray const& cba = grids[lev-1];
+        const IntVect rr = info.ref_ratio.back();
+        const IntVect bf = info.blocking_factor.back();
+        AMREX_ALWAYS_ASSERT(fba.isDisjoint());
+        AMREX_ALWAYS_ASSERT(cba.contains(amrex::coarsen(fba,rr)));
+        for (int i = 0, N = static_cast<int>(fba.size()); i < N; ++i) {
+            AMREX_ALWAYS_ASSERT(fba[i].coarsenable(bf));
+        }
+
+        // Every tag of the coarse level is covered by the fine grids.  The
+        // domain is not periodic, so no tag of level 0 is outside the
+        // proper nesting domain.
+        if (lev == 1) {
+            const auto problo = lgeom.ProbLoArray();
+            const auto dx = lgeom.CellSizeArray();
+            const BoxArray cfba = amrex::coarsen(fba,rr);
+            Long nmissed = 0;
+            for (BoxIterator bi(geom.Domain()); bi.ok(); ++bi) {
+                if (tagged(cell_center(bi(), problo, dx)) && !cfba.contains(bi())) {
+                    ++nmissed;
+                }
+            }
+            AMREX_ALWAYS_ASSERT(nmissed == 0);
+        }
+        lgeom = amrex::refine(lgeom, rr);
+    }
+}
+
+void test_clustering (TestParams const& p, AmrInfo const& info, bool must_be_equal)
+{
+    const Box domain(IntVect(0), IntVect(p.n_cell-1));
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,0)};
+    Geometry geom(domain, rb, CoordSys::cartesian, is_periodic);
+
+    const auto serial = make_grids(geom, info, false);
+    const auto distributed = make_grids(geom, info, true);
+
+    check_grids(serial, geom, info);
+    check_grids(distributed, geom, info);
+
+    bool same = serial.size() == distributed.size();
+    const int nlevs = static_cast<int>(std::min(serial.size(), distributed.size()));
+    for (int lev = 0; lev < nlevs; ++lev) {
+        amrex::Print() << "  level " << lev << ": " << serial[lev].size() << " serial boxes with "
+                       << serial[lev].numPts() << " cells, " << distributed[lev].size()
+                       << " distributed boxes with " << distributed[lev].numPts() << " cells\n";
+        same = same && (serial[lev] == distributed[lev]);
+    }
+    amrex::Print() << "  the grids are " << (same ? "the same" : "different") << "\n";
+    if (must_be_equal) {
+        AMREX_ALWAYS_ASSERT(same);
+    }
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        TestParams p;
+        {
+            ParmParse pp;
+            pp.query("n_cell", p.n_cell);
+            pp.query("max_grid_size", p.max_grid_size);
+            pp.query("max_level", p.max_level);
+        }
+
+        AmrInfo info;
+        info.max_level = p.max_level;
+        info.ref_ratio = {IntVect(2)};
+        info.blocking_factor = {IntVect(8)};
+        info.max_grid_size = {IntVect(p.max_grid_size)};
+        info.n_error_buf = {IntVect(2)};
+
+        // A single coarse grid, so that the tags of level 0 are all on one
+        // process and both modes run the same chop on the same tags.
+        amrex::Print() << "Single coarse grid\n";
+        {
+            AmrInfo info1 = info;
+            info1.max_level = 1;
+            info1.max_grid_size = {IntVect(p.n_cell), IntVect(p.max_grid_size)};
+            info1.refine_grid_layout = false;
+            test_clustering(p, info1, true);
+        }
+
+        amrex::Print() << "Coarse grids of size " << p.max_grid_size << "\n";
+        test_clustering(p, info, ParallelDescriptor::NProcs() == 1);
+    }
+    amrex::Finalize();
+}
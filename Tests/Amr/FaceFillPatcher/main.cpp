@@ -0,0 +1,224 @@
+//
+// Compares FillPatcher with FillPatchTwoLevels for face-centered data,
+// one direction at a time with face_linear_interp and all directions
+// together with face_divfree_interp.
+//
+
+#include <AMReX.H>
+#include <AMReX_FillPatcher.H>
+#include <AMReX_FillPatchUtil.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_PhysBCFunct.H>
+
+using namespace amrex;
+
+namespace {
+
+void init (MultiFab& mf, Geometry const& geom, Real t, int dir)
+{
+    auto const dx = geom.CellSizeArray();
+    auto const& a = mf.arrays();
+    ParallelFor(mf, IntVect(0), mf.nComp(),
+    [=] AMREX_GPU_DEVICE (int b, int i, int j, int k, int n) noexcept
+    {
+        amrex::ignore_unused(j,k);
+        Real x = (i + (dir == 0 ? Real(0.) : Real(0.5))) * dx[0];
+        Real y = (AMREX_SPACEDIM >= 2) ? (j + (dir == 1 ? Real(0.) : Real(0.5))) * dx[1] : Real(0.);
+        Real z = (AMREX_SPACEDIM == 3) ? (k + (dir == 2 ? Real(0.) : Real(0.5))) * dx[2] : Real(0.);
+        a[b](i,j,k,n) = std::sin(Real(2.*3.141592653589793)*x)*std::cos(Real(3.)*y)
+            + z*z*Real(n+1) + t + Real(dir);
+    });
+}
+
+Real max_diff (MultiFab& a, MultiFab const& b, int ncomp, int nghost)
+{
+    MultiFab::Subtract(a, b, 0, 0, ncomp, nghost);
+    Real r = 0;
+    for (int n = 0; n < ncomp; ++n) {
+        r = std::max(r, a.norminf(n, nghost));
+    }
+    return r;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 32;
+        int max_grid_size = 8;
+        int nghost = 2;
+        int ncomp = 2;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("nghost", nghost);
+            pp.query("ncomp", ncomp);
+        }
+
+        const Box cdomain(IntVect(0), IntVect(n_cell-1));
+        const IntVect ratio(2);
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(1,0,0)};
+        Geometry cgeom(cdomain, rb, CoordSys::cartesian, is_periodic);
+        Geometry fgeom(amrex::refine(cdomain,ratio), rb, CoordSys::cartesian, is_periodic);
+
+        BoxArray cba(cdomain);
+        cba.maxSize(max_grid_size);
+        DistributionMapping cdm(cba);
+
+        // Fine boxes next to each other, and touching the periodic and the
+        // non-periodic boundaries
+        const int n = 2*n_cell;
+        BoxList fbl;
+        fbl.push_back(Box(IntVect(n/4), IntVect(n/2-1)));
+        fbl.push_back(Box(IntVect(AMREX_D_DECL(n/2,n/4,n/4)),
+                          IntVect(AMREX_D_DECL(3*n/4-1,n/2-1,n/2-1))));
+        fbl.push_back(Box(IntVect(AMREX_D_DECL(0,3*n/8,3*n/8)),
+                          IntVect(AMREX_D_DECL(n/8-1,5*n/8-1,5*n/8-1))));
+        fbl.push_back(Box(IntVect(AMREX_D_DECL(7*n/8,3*n/8,0)),
+                          IntVect(AMREX_D_DECL(n-1,5*n/8-1,n/8-1))));
+        BoxArray fba(fbl);
+        fba.maxSize(max_grid_size);
+        DistributionMapping fdm(fba);
+
+        BCRec bc;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            bc.setLo(idim, is_periodic[idim] ? BCType::int_dir : BCType::foextrap);
+            bc.setHi(idim, is_periodic[idim] ? BCType::int_dir : BCType::foextrap);
+        }
+        Vector<BCRec> bcs(ncomp, bc);
+        PhysBCFunctNoOp nobc;
+        Array<Vector<BCRec>,AMREX_SPACEDIM> abcs;
+        Array<PhysBCFunctNoOp,AMREX_SPACEDIM> anobc;
+        for (auto& b : abcs) { b = bcs; }
+
+        const IntVect ng(nghost);
+        const Real time = Real(0.25);
+        Real diff = 0;
+
+        Array<MultiFab,AMREX_SPACEDIM> c0, c1, f0, f1, mfa, mfb;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            const IntVect t = IntVect::TheDimensionVector(idim);
+            c0[idim].define(amrex::convert(cba,t), cdm, ncomp, 0);
+            c1[idim].define(amrex::convert(cba,t), cdm, ncomp, 0);
+            f0[idim].define(amrex::convert(fba,t), fdm, ncomp, 0);
+            f1[idim].define(amrex::convert(fba,t), fdm, ncomp, 0);
+            mfa[idim].define(amrex::convert(fba,t), fdm, ncomp, ng);
+            mfb[idim].define(amrex::convert(fba,t), fdm, ncomp, ng);
+            init(c0[idim], cgeom, Real(0.), idim);
+            init(c1[idim], cgeom, Real(1.), idim);
+            init(f0[idim], fgeom, Real(0.), idim);
+            init(f1[idim], fgeom, Real(1.), idim);
+        }
+
+        // One direction at a time.  For face data, FillPatchTwoLevels marks
+        // the known fine faces in the first component of the interpolation
+        // mask only, whereas FillPatcher marks them in all the components,
+        // so FillPatchTwoLevels is called for one component at a time as
+        // the reference.
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            auto& a = mfa[idim];
+            auto& b = mfb[idim];
+            FillPatcher<MultiFab> fp(a.boxArray(), fdm, fgeom, c0[idim].boxArray(), cdm, cgeom,
+                                     ng, ncomp, &face_linear_interp);
+            b.setVal(-1.);
+            for (int n = 0; n < ncomp; ++n) {
+                FillPatchTwoLevels(b, ng, time, {&c0[idim],&c1[idim]}, {0.,1.},
+                                   {&f0[idim],&f1[idim]}, {0.,1.}, n, n, 1, cgeom, fgeom,
+                                   nobc, n, nobc, n, ratio, &face_linear_interp, bcs, n);
+            }
+
+            // Twice, the second time with the cached coarse data
+            for (int it = 0; it < 2; ++it) {
+                a.setVal(-1.);
+                fp.fill(a, ng, time, {&c0[idim],&c1[idim]}, {0.,1.},
+                        {&f0[idim],&f1[idim]}, {0.,1.}, 0, 0, ncomp, nobc, 0, nobc, 0, bcs, 0);
+                diff = std::max(diff, max_diff(a, b, ncomp, nghost));
+            }
+
+            b.setVal(-1.);
+            for (int n = 0; n < ncomp; ++n) {
+                FillPatchTwoLevels(b, ng, Real(0.), {&c0[idim]}, {0.}, {&f0[idim]}, {0.},
+                                   n, n, 1, cgeom, fgeom, nobc, n, nobc, n, ratio,
+                                   &face_linear_interp, bcs, n);
+            }
+
+            a.setVal(-1.);
+            MultiFab::Copy(a, f0[idim], 0, 0, ncomp, 0);
+            fp.fillCoarseFineBoundary(a, ng, Real(0.), {&c0[idim]}, {0.}, 0, 0, ncomp,
+                                      nobc, 0, bcs, 0);
+            a.FillBoundary(fgeom.periodicity());
+            diff = std::max(diff, max_diff(a, b, ncomp, nghost));
+
+            // RK with all the stages equal to zero, so that the coarse data
+            // are those at the beginning of the step
+            FillPatcher<MultiFab> fprk(a.boxArray(), fdm, fgeom, c0[idim].boxArray(), cdm, cgeom,
+                                       ng, ncomp, &face_linear_interp);
+            Array<MultiFab,3> rkk;
+            for (auto& k : rkk) {
+                k.define(c0[idim].boxArray(), cdm, ncomp, 0);
+                k.setVal(0.);
+            }
+            fprk.storeRKCoarseData(Real(0.), Real(1.), c0[idim], rkk);
+            a.setVal(-1.);
+            MultiFab::Copy(a, f0[idim], 0, 0, ncomp, 0);
+            fprk.fillRK(1, 1, 2, a, Real(0.), nobc, nobc, bcs);
+            diff = std::max(diff, max_diff(a, b, ncomp, nghost));
+        }
+        amrex::Print() << "face_linear_interp: max difference " << diff << "\n";
+        AMREX_ALWAYS_ASSERT(diff < Real(1.e-12));
+
+        // All directions together
+        diff = 0;
+        Array<MultiFab*,AMREX_SPACEDIM> pa, pb, pc0, pc1, pf0, pf1;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            pa[idim] = &mfa[idim];
+            pb[idim] = &mfb[idim];
+            pc0[idim] = &c0[idim];
+            pc1[idim] = &c1[idim];
+            pf0[idim] = &f0[idim];
+            pf1[idim] = &f1[idim];
+        }
+        FillPatcher<MultiFab> fp(fba, fdm, fgeom, cba, cdm, cgeom, ng, ncomp,
+                                 &face_divfree_interp);
+
+        for (auto& b : mfb) { b.setVal(-1.); }
+        for (int n = 0; n < ncomp; ++n) {
+            FillPatchTwoLevels(pb, ng, time, {pc0,pc1}, {0.,1.}, {pf0,pf1}, {0.,1.},
+                               n, n, 1, cgeom, fgeom, anobc, n, anobc, n, ratio,
+                               &face_divfree_interp, abcs, n);
+        }
+        for (int it = 0; it < 2; ++it) {
+            for (auto& a : mfa) { a.setVal(-1.); }
+            fp.fill(pa, ng, time, {pc0,pc1}, {0.,1.}, {pf0,pf1}, {0.,1.}, 0, 0, ncomp,
+                    anobc, 0, anobc, 0, abcs, 0);
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                diff = std::max(diff, max_diff(mfa[idim], mfb[idim], ncomp, nghost));
+            }
+        }
+
+        for (auto& b : mfb) { b.setVal(-1.); }
+        for (int n = 0; n < ncomp; ++n) {
+            FillPatchTwoLevels(pb, ng, Real(0.), {pc0}, {0.}, {pf0}, {0.},
+                               n, n, 1, cgeom, fgeom, anobc, n, anobc, n, ratio,
+                               &face_divfree_interp, abcs, n);
+        }
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            mfa[idim].setVal(-1.);
+            MultiFab::Copy(mfa[idim], f0[idim], 0, 0, ncomp, 0);
+        }
+        fp.fillCoarseFineBoundary(pa, ng, Real(0.), {pc0}, {0.}, 0, 0, ncomp,
+                                  anobc, 0, abcs, 0);
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            mfa[idim].FillBoundary(fgeom.periodicity());
+            diff = std::max(diff, max_diff(mfa[idim], mfb[idim], ncomp, nghost));
+        }
+        amrex::Print() << "face_divfree_interp: max difference " << diff << "\n";
+        AMREX_ALWAYS_ASSERT(diff < Real(1.e-12));
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,150 @@
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_PhysBCFunct.H>
+#include <AMReX_FillPatchUtil.H>
+
+using namespace amrex;
+
+namespace {
+
+void init (MultiFab& mf, Geometry const& geom, Real t, Real shift)
+{
+    auto const dx = geom.CellSizeArray();
+    auto const& a = mf.arrays();
+    ParallelFor(mf, IntVect(0), mf.nComp(),
+    [=] AMREX_GPU_DEVICE (int b, int i, int j, int k, int n) noexcept
+    {
+        Real x = (i+Real(0.5))*dx[0];
+        Real y = (j+Real(0.5))*dx[1];
+        Real z = (k+Real(0.5))*dx[2];
+        a[b](i,j,k,n) = std::sin(Real(2.*3.141592653589793)*x)*std::cos(Real(3.)*y)
+            + z*z*Real(n+1) + t + shift;
+    });
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 32;
+        int max_grid_size = 8;
+        int nghost = 2;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("nghost", nghost);
+        }
+
+        const Box cdomain(IntVect(0), IntVect(n_cell-1));
+        const IntVect ratio(2);
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(1,0,1)};
+        Geometry cgeom(cdomain, rb, CoordSys::cartesian, is_periodic);
+        Geometry fgeom(amrex::refine(cdomain,ratio), rb, CoordSys::cartesian, is_periodic);
+
+        BoxArray cba(cdomain);
+        cba.maxSize(max_grid_size);
+        DistributionMapping cdm(cba);
+
+        // Fine boxes touching the periodic and the non-periodic boundaries
+        const int n = 2*n_cell;
+        BoxList fbl;
+        fbl.push_back(Box(IntVect(n/4), IntVect(n/2-1)));
+        fbl.push_back(Box(IntVect(AMREX_D_DECL(0,n/2,n/2)),
+                          IntVect(AMREX_D_DECL(n/8-1,3*n/4-1,3*n/4-1))));
+        fbl.push_back(Box(IntVect(AMREX_D_DECL(7*n/8,0,n/2)),
+                          IntVect(AMREX_D_DECL(n-1,n/8-1,3*n/4-1))));
+        BoxArray fba(fbl);
+        fba.maxSize(max_grid_size);
+        DistributionMapping fdm(fba);
+
+        // A second fine BoxArray, so that there are two batches
+        BoxArray fba2(Box(IntVect(n/4), IntVect(3*n/4-1)));
+        fba2.maxSize(max_grid_size);
+        DistributionMapping fdm2(fba2);
+
+        Vector<BCRec> bcs(3);
+        for (auto& bc : bcs) {
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                bc.setLo(idim, is_periodic[idim] ? BCType::int_dir : BCType::foextrap);
+                bc.setHi(idim, is_periodic[idim] ? BCType::int_dir : BCType::foextrap);
+            }
+        }
+        PhysBCFunctNoOp nobc;
+
+        const Real time = Real(0.25);
+        const IntVect ng(nghost);
+
+        // Group 0 and 1 share the fine grids and have two coarse time
+        // levels, group 2 has one coarse time level and group 3 is on
+        // different fine grids.
+        const Vector<int> ncomp{2, 1, 3, 2};
+        const Vector<int> nctime{2, 2, 1, 2};
+        Vector<BoxArray const*> gba{&fba, &fba, &fba, &fba2};
+        Vector<DistributionMapping const*> gdm{&fdm, &fdm, &fdm, &fdm2};
+        const int ngroups = static_cast<int>(ncomp.size());
+
+        Vector<Array<MultiFab,2>> cmf(ngroups), fmf(ngroups);
+        Vector<MultiFab> mf_batched(ngroups), mf_single(ngroups);
+        for (int i = 0; i < ngroups; ++i) {
+            for (int t = 0; t < 2; ++t) {
+                cmf[i][t].define(cba, cdm, ncomp[i]+1, 0);
+                fmf[i][t].define(*gba[i], *gdm[i], ncomp[i]+1, 0);
+                init(cmf[i][t], cgeom, Real(t), Real(i));
+                init(fmf[i][t], fgeom, Real(t), Real(i));
+            }
+            mf_batched[i].define(*gba[i], *gdm[i], ncomp[i], ng);
+            mf_single[i].define(*gba[i], *gdm[i], ncomp[i], ng);
+            mf_batched[i].setVal(Real(-1.));
+            mf_single[i].setVal(Real(-1.));
+        }
+
+        // Take the components starting at 1 to test scomp.
+        Vector<FillPatchGroup<MultiFab,PhysBCFunctNoOp,Interpolater>> groups(ngroups);
+        for (int i = 0; i < ngroups; ++i) {
+            auto& g = groups[i];
+            g.mf = &mf_batched[i];
+            if (nctime[i] == 2) {
+                g.cmf = {&cmf[i][0], &cmf[i][1]};
+                g.ct = {Real(0.), Real(1.)};
+            } else {
+                g.cmf = {&cmf[i][0]};
+                g.ct = {time};
+            }
+            g.fmf = {&fmf[i][0], &fmf[i][1]};
+            g.ft = {Real(0.), Real(1.)};
+            g.scomp = 1;
+            g.dcomp = 0;
+            g.ncomp = ncomp[i];
+            g.cbc = &nobc;
+            g.fbc = &nobc;
+            g.mapper = &cell_cons_interp;
+            g.bcs = bcs;
+        }
+
+        FillPatchTwoLevels(groups, ng, time, cgeom, fgeom, ratio);
+
+        for (int i = 0; i < ngroups; ++i) {
+            auto const& g = groups[i];
+            FillPatchTwoLevels(mf_single[i], ng, time, g.cmf, g.ct, g.fmf, g.ft,
+                               g.scomp, g.dcomp, g.ncomp, cgeom, fgeom,
+                               nobc, 0, nobc, 0, ratio, g.mapper, g.bcs, 0);
+        }
+
+        Real max_diff = 0;
+        for (int i = 0; i < ngroups; ++i) {
+            MultiFab::Subtract(mf_batched[i], mf_single[i], 0, 0, ncomp[i], ng);
+            for (int n = 0; n < ncomp[i]; ++n) {
+                max_diff = std::max(max_diff, mf_batched[i].norminf(n, nghost));
+            }
+        }
+        amrex::Print() << "Max difference between batched and single FillPatchTwoLevels: "
+                       << max_diff << "\n";
+        AMREX_ALWAYS_ASSERT(max_diff < Real(1.e-12));
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,159 @@
+//
+// Moves fine level data to new grids with FillPatchRegrid and compares
+// them with FillPatchTwoLevels into a new MultiFab.  The new grids keep
+// some of the old boxes, shift others so that they partly overlap the old
+// grids, and add boxes that were not refined before.  The unchanged FABs
+// must be moved, not copied, unless the data are in a single chunk.
+//
+
+#include <AMReX.H>
+#include <AMReX_FillPatchUtil.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_PhysBCFunct.H>
+
+#include <map>
+
+using namespace amrex;
+
+namespace {
+
+void init (MultiFab& mf, Geometry const& geom, Real t, Real shift)
+{
+    auto const dx = geom.CellSizeArray();
+    auto const& a = mf.arrays();
+    ParallelFor(mf, IntVect(0), mf.nComp(),
+    [=] AMREX_GPU_DEVICE (int b, int i, int j, int k, int n) noexcept
+    {
+        Real x = (i+Real(0.5))*dx[0];
+        Real y = (j+Real(0.5))*dx[1];
+        Real z = (k+Real(0.5))*dx[2];
+        a[b](i,j,k,n) = std::sin(Real(2.*3.141592653589793)*x)*std::cos(Real(3.)*y)
+            + z*z*Real(n+1) + t + shift;
+    });
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 32;
+        int max_grid_size = 8;
+        int nghost = 2;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("nghost", nghost);
+        }
+
+        const Box cdomain(IntVect(0), IntVect(n_cell-1));
+        const IntVect ratio(2);
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(1,0,1)};
+        Geometry cgeom(cdomain, rb, CoordSys::cartesian, is_periodic);
+        Geometry fgeom(amrex::refine(cdomain,ratio), rb, CoordSys::cartesian, is_periodic);
+
+        BoxArray cba(cdomain);
+        cba.maxSize(max_grid_size);
+        DistributionMapping cdm(cba);
+
+        const int n = 2*n_cell;
+        const Box kept(IntVect(n/4), IntVect(n/2-1));
+        const Box moved(IntVect(AMREX_D_DECL(n/2,n/4,n/4)), IntVect(AMREX_D_DECL(3*n/4-1,n/2-1,n/2-1)));
+
+        BoxArray old_ba(BoxList(Vector<Box>{kept, moved}));
+        old_ba.maxSize(max_grid_size);
+        DistributionMapping old_dm(old_ba);
+
+        // The kept boxes have the same owners as before.  The moved box
+        // overlaps its old position, and the last box is new and touches
+        // the periodic boundary.
+        BoxArray new_ba(BoxList(Vector<Box>{kept, amrex::shift(moved, 1, max_grid_size/2),
+                                            Box(IntVect(AMREX_D_DECL(0,n/2,n/2)),
+                                                IntVect(AMREX_D_DECL(n/8-1,3*n/4-1,3*n/4-1)))}));
+        new_ba.maxSize(max_grid_size);
+        Vector<int> pmap(new_ba.size());
+        int nkept = 0;
+        for (int i = 0; i < static_cast<int>(new_ba.size()); ++i) {
+            pmap[i] = i % ParallelDescriptor::NProcs();
+            for (int iold = 0; iold < static_cast<int>(old_ba.size()); ++iold) {
+                if (old_ba[iold] == new_ba[i]) {
+                    pmap[i] = old_dm[iold];
+                    ++nkept;
+                }
+            }
+        }
+        DistributionMapping new_dm(std::move(pmap));
+        AMREX_ALWAYS_ASSERT(nkept > 0 && nkept < static_cast<int>(new_ba.size()));
+
+        const int ncomp = 2;
+        Vector<BCRec> bcs(ncomp);
+        for (auto& bc : bcs) {
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                bc.setLo(idim, is_periodic[idim] ? BCType::int_dir : BCType::foextrap);
+                bc.setHi(idim, is_periodic[idim] ? BCType::int_dir : BCType::foextrap);
+            }
+        }
+        PhysBCFunctNoOp nobc;
+
+        const Real time = Real(0.25);
+        const IntVect ng(nghost);
+
+        Array<MultiFab,2> cmf;
+        for (int t = 0; t < 2; ++t) {
+            cmf[t].define(cba, cdm, ncomp, 0);
+            init(cmf[t], cgeom, Real(t), Real(0.));
+        }
+        const Vector<MultiFab*> cmfs{&cmf[0], &cmf[1]};
+        const Vector<Real> ct{Real(0.), Real(1.)};
+
+        for (bool single_chunk : {false, true}) {
+            // The old level data differ from the coarse data, so that it
+            // matters where they come from.
+            MultiFab mf(old_ba, old_dm, ncomp, ng, MFInfo().SetAllocSingleChunk(single_chunk));
+            init(mf, fgeom, time, Real(0.5));
+            FillPatchTwoLevels(mf, ng, time, cmfs, ct, {&mf}, {time}, 0, 0, ncomp,
+                               cgeom, fgeom, nobc, 0, nobc, 0, ratio, &cell_cons_interp, bcs, 0);
+
+            // The valid cells are filled from the old level and the coarse
+            // level, and the ghost cells from the new level and the coarse level.
+            MultiFab mf_ref(new_ba, new_dm, ncomp, ng);
+            FillPatchTwoLevels(mf_ref, IntVect(0), time, cmfs, ct, {&mf}, {time}, 0, 0, ncomp,
+                               cgeom, fgeom, nobc, 0, nobc, 0, ratio, &cell_cons_interp, bcs, 0);
+            FillPatchTwoLevels(mf_ref, ng, time, cmfs, ct, {&mf_ref}, {time}, 0, 0, ncomp,
+                               cgeom, fgeom, nobc, 0, nobc, 0, ratio, &cell_cons_interp, bcs, 0);
+
+            std::map<int,Real const*> old_data;
+            for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+                old_data[mfi.index()] = mf[mfi].dataPtr();
+            }
+
+            FillPatchRegrid(mf, new_ba, new_dm, time, cmfs, ct, cgeom, fgeom,
+                            nobc, 0, nobc, 0, ratio, &cell_cons_interp, bcs, 0);
+
+            AMREX_ALWAYS_ASSERT(mf.boxArray() == new_ba && mf.DistributionMap() == new_dm);
+            AMREX_ALWAYS_ASSERT(mf.nGrowVect() == ng && mf.nComp() == ncomp);
+
+            // Count the FABs that kept their memory.
+            int nmoved = 0;
+            for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+                for (auto const& [iold, p] : old_data) {
+                    if (old_ba[iold] == mfi.validbox() && mf[mfi].dataPtr() == p) { ++nmoved; }
+                }
+            }
+            ParallelDescriptor::ReduceIntSum(nmoved);
+
+            MultiFab::Subtract(mf_ref, mf, 0, 0, ncomp, ng);
+            const Real max_diff = mf_ref.norminf(0, ncomp, ng);
+            amrex::Print() << (single_chunk ? "Single chunk" : "Separate FABs") << ": "
+                           << nmoved << " of " << new_ba.size() << " FABs moved, "
+                           << "max difference with FillPatchTwoLevels " << max_diff << "\n";
+            AMREX_ALWAYS_ASSERT(nmoved == (single_chunk ? 0 : nkept));
+            AMREX_ALWAYS_ASSERT(max_diff < Real(1.e-12));
+        }
+    }
+    amrex::Finalize();
+}
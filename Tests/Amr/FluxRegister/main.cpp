@@ -0,0 +1,191 @@
+//
+// Checks the MultiFab versions of FluxRegister::FineAdd, which are batched
+// over all the boxes on GPU, against FineAdd called box by box, and the
+// Reflux over all faces, which uses a single ParallelAdd, against Reflux
+// called face by face.  The fine grids touch each other and the periodic
+// boundaries.  The register is then cleared and redefined on other grids.
+//
+
+#include <AMReX.H>
+#include <AMReX_FluxRegister.H>
+#include <AMReX_Geometry.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+namespace {
+
+constexpr int ncomp = 2;
+
+void fill (MultiFab& mf, Real a)
+{
+    auto const& ma = mf.arrays();
+    ParallelFor(mf, IntVect(0), mf.nComp(),
+    [=] AMREX_GPU_DEVICE (int b, int i, int j, int k, int n) noexcept
+    {
+        ma[b](i,j,k,n) = std::sin(a + Real(0.3)*i + Real(0.7)*j + Real(1.1)*k + Real(n));
+    });
+    Gpu::streamSynchronize();
+}
+
+// Max difference between the registers of all faces
+Real register_diff (FluxRegister const& a, FluxRegister const& b)
+{
+    Real diff = 0;
+    for (OrientationIter fi; fi; ++fi) {
+        auto const& fa = a[fi()];
+        auto const& fb = b[fi()];
+        ReduceOps<ReduceOpMax> reduce_op;
+        ReduceData<Real> reduce_data(reduce_op);
+        for (MFIter mfi(fa.boxArray(), fa.DistributionMap()); mfi.isValid(); ++mfi) {
+            auto const& aa = fa.const_array(mfi);
+            auto const& ba = fb.const_array(mfi);
+            reduce_op.eval(mfi.validbox(), ncomp, reduce_data,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) -> GpuTuple<Real>
+            {
+                return { std::abs(aa(i,j,k,n) - ba(i,j,k,n)) };
+            });
+        }
+        diff = std::max(diff, amrex::get<0>(reduce_data.value(reduce_op)));
+    }
+    ParallelDescriptor::ReduceRealMax(diff);
+    return diff;
+}
+
+Real test_fluxreg (BoxArray const& fba, BoxArray const& cba, DistributionMapping const& cdm,
+                   Geometry const& cgeom, IntVect const& ratio, FluxRegister& fr,
+                   FluxRegister& fr_ref)
+{
+    DistributionMapping fdm(fba);
+
+    fr.clear();
+    fr_ref.clear();
+    fr.define(fba, fdm, ratio, 1, ncomp);
+    fr_ref.define(fba, fdm, ratio, 1, ncomp);
+    fr.setVal(0.0);
+    fr_ref.setVal(0.0);
+
+    const Real fine_scale = Real(1.0) / Real(AMREX_D_TERM(1,*ratio[1],*ratio[2]));
+    for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+        const IntVect nodal = IntVect::TheDimensionVector(dir);
+        MultiFab cflux(amrex::convert(cba,nodal), cdm, ncomp, 0);
+        MultiFab carea(amrex::convert(cba,nodal), cdm, 1, 0);
+        MultiFab fflux(amrex::convert(fba,nodal), fdm, ncomp, 0);
+        MultiFab farea(amrex::convert(fba,nodal), fdm, 1, 0);
+        fill(cflux, Real(dir));
+        fill(fflux, Real(dir+10));
+        carea.setVal(Real(4.0));
+        farea.setVal(Real(1.0)+Real(0.5)*dir);
+
+        // Component 0 without area, component 1 with area
+        for (auto* r : {&fr, &fr_ref}) {
+            r->CrseInit(cflux, dir, 0, 0, 1);
+            r->CrseInit(cflux, carea, dir, 1, 1, 1);
+        }
+
+        fr.FineAdd(fflux, dir, 0, 0, 1, fine_scale);
+        fr.FineAdd(fflux, farea, dir, 1, 1, 1, fine_scale);
+
+        for (MFIter mfi(fflux); mfi.isValid(); ++mfi) {
+            fr_ref.FineAdd(fflux[mfi], dir, mfi.index(), 0, 0, 1, fine_scale, RunOn::Gpu);
+            fr_ref.FineAdd(fflux[mfi], farea[mfi], dir, mfi.index(), 1, 1, 1, fine_scale,
+                           RunOn::Gpu);
+        }
+        Gpu::streamSynchronize();
+    }
+
+    const Real diff_fineadd = register_diff(fr, fr_ref);
+    amrex::Print() << "  FineAdd: max difference " << diff_fineadd << "\n";
+    AMREX_ALWAYS_ASSERT(diff_fineadd == Real(0.0));
+
+    MultiFab volume(cba, cdm, 1, 0);
+    fill(volume, Real(20.));
+    volume.plus(Real(2.0), 0, 1);
+
+    MultiFab state(cba, cdm, ncomp, 0);
+    fill(state, Real(30.));
+    MultiFab state_ref(cba, cdm, ncomp, 0);
+    MultiFab::Copy(state_ref, state, 0, 0, ncomp, 0);
+
+    fr.Reflux(state, volume, Real(1.0), 0, 0, ncomp, cgeom);
+    for (OrientationIter fi; fi; ++fi) {
+        fr_ref.Reflux(state_ref, volume, fi(), Real(1.0), 0, 0, ncomp, cgeom);
+    }
+
+    // Make sure that the comparison is not trivial.
+    MultiFab state_old(cba, cdm, ncomp, 0);
+    fill(state_old, Real(30.));
+    MultiFab::Subtract(state_old, state, 0, 0, ncomp, 0);
+    const Real correction = state_old.norminf(0, ncomp, IntVect(0));
+    amrex::Print() << "  Reflux: max correction " << correction << "\n";
+    AMREX_ALWAYS_ASSERT(correction > Real(0.1));
+
+    MultiFab::Subtract(state_ref, state, 0, 0, ncomp, 0);
+    const Real diff_reflux = state_ref.norminf(0, ncomp, IntVect(0));
+    amrex::Print() << "  Reflux: max difference " << diff_reflux << "\n";
+    return diff_reflux;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 32;
+        int max_grid_size = 16;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+        }
+
+        const Box cdomain(IntVect(0), IntVect(n_cell-1));
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(1,1,1)};
+        Geometry cgeom(cdomain, rb, CoordSys::cartesian, is_periodic);
+        const IntVect ratio(2);
+
+        BoxArray cba(cdomain);
+        cba.maxSize(max_grid_size);
+        DistributionMapping cdm(cba);
+
+        const int n = n_cell*2;
+        const Box fdomain = amrex::refine(cdomain, ratio);
+
+        // Two boxes side by side in the interior, and two boxes that are
+        // neighbors across the periodic boundary in the first direction.
+        BoxList fbl;
+        fbl.push_back(Box(IntVect(n/8), IntVect(3*n/8-1)));
+        fbl.push_back(Box(IntVect(AMREX_D_DECL(3*n/8,n/8,n/8)),
+                          IntVect(AMREX_D_DECL(5*n/8-1,3*n/8-1,3*n/8-1))));
+        fbl.push_back(Box(IntVect(AMREX_D_DECL(7*n/8,n/2,n/2)), fdomain.bigEnd()));
+        fbl.push_back(Box(IntVect(AMREX_D_DECL(0,n/2,n/2)),
+                          IntVect(AMREX_D_DECL(n/16-1,3*n/4-1,n-1))));
+        BoxArray fba(fbl);
+        fba.maxSize(max_grid_size);
+
+        // Grids with a different number of boxes, for the redefinition
+        BoxArray fba2(Box(IntVect(n/4), IntVect(3*n/4-1)));
+        fba2.maxSize(max_grid_size/2);
+
+        FluxRegister fr, fr_ref;
+        Real tol = 0;
+        {
+            MultiFab state(cba, cdm, ncomp, 0);
+            fill(state, Real(30.));
+            tol = Real(1.e-12) * state.norminf(0, ncomp, IntVect(0));
+        }
+
+        amrex::Print() << "Fine grids with " << fba.size() << " boxes\n";
+        const Real diff = test_fluxreg(fba, cba, cdm, cgeom, ratio, fr, fr_ref);
+        AMREX_ALWAYS_ASSERT(diff <= tol);
+
+        amrex::Print() << "Redefined on fine grids with " << fba2.size() << " boxes\n";
+        const Real diff2 = test_fluxreg(fba2, cba, cdm, cgeom, ratio, fr, fr_ref);
+        AMREX_ALWAYS_ASSERT(diff2 <= tol);
+    }
+    amrex::Finalize();
+}
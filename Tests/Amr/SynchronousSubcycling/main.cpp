@@ -0,0 +1,312 @@
+//
+// Runs the same two-level problem with amr.subcycling_mode = None and
+// Synchronous, with a regrid requested by level 0 after every step, and
+// checks that both modes give the same grids and data.  Each level also
+// checks that post_timestep is called on the grids it was advanced on.
+//
+
+#include <AMReX.H>
+#include <AMReX_Amr.H>
+#include <AMReX_AmrLevel.H>
+#include <AMReX_LevelBld.H>
+#include <AMReX_MultiFabUtil.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_PhysBCFunct.H>
+
+#include <cmath>
+
+using namespace amrex;
+
+extern "C" {
+    void amrex_probinit (const int* /*init*/,
+                         const int* /*name*/,
+                         const int* /*namelen*/,
+                         const amrex::Real* /*problo*/,
+                         const amrex::Real* /*probhi*/)
+    {
+        // No problem parameters
+    }
+}
+
+namespace {
+
+Real fixed_dt = Real(0.05);
+
+// The data are phi = x0 + t*(1 + 2*x0), which is linear in x0 and
+// constant in the other directions.  The refined region stays away from
+// the periodic boundaries in x0, so that the interpolation and averaging
+// between the levels are exact, and both modes give the same data up to
+// roundoff even though they regrid at different points of the step.
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+Real source (Real x) noexcept
+{
+    return Real(1.) + Real(2.)*x;
+}
+
+// The refined region moves with time, so that the post-step regrids
+// change the grids.
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+bool tagged (Real x, Real time) noexcept
+{
+    const Real center = Real(0.35) + Real(0.8)*time;
+    return std::abs(x - center) < Real(0.08);
+}
+
+struct NullFill
+{
+    AMREX_GPU_DEVICE
+    void operator() (const IntVect& /*iv*/, Array4<Real> const& /*dest*/,
+                     int /*dcomp*/, int /*numcomp*/,
+                     GeometryData const& /*geom*/, Real /*time*/,
+                     const BCRec* /*bcr*/, int /*bcomp*/,
+                     int /*orig_comp*/) const
+    {
+    }
+};
+
+void nullfill (Box const& bx, FArrayBox& data,
+               int dcomp, int numcomp,
+               Geometry const& geom, Real time,
+               const Vector<BCRec>& bcr, int bcomp,
+               int scomp)
+{
+    GpuBndryFuncFab<NullFill> gpu_bndry_func(NullFill{});
+    gpu_bndry_func(bx,data,dcomp,numcomp,geom,time,bcr,bcomp,scomp);
+}
+
+}
+
+class SyncLevel
+    :
+    public AmrLevel
+{
+public:
+
+    SyncLevel () = default;
+
+    SyncLevel (Amr& papa, int lev, const Geometry& level_geom,
+               const BoxArray& bl, const DistributionMapping& dm, Real time)
+        : AmrLevel(papa,lev,level_geom,bl,dm,time)
+    {}
+
+    static void variableSetUp ()
+    {
+        desc_lst.addDescriptor(0, IndexType::TheCellType(),
+                               StateDescriptor::Point, 0, 1,
+                               &cell_cons_interp);
+        BCRec bc;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            bc.setLo(idim, BCType::int_dir);
+            bc.setHi(idim, BCType::int_dir);
+        }
+        StateDescriptor::BndryFunc bndryfunc(nullfill);
+        bndryfunc.setRunOnGPU(true);
+        desc_lst.setComponent(0, 0, "phi", bc, bndryfunc);
+    }
+
+    static void variableCleanUp () { desc_lst.clear(); }
+
+    void computeInitialDt (int finest_level, int /*sub_cycle*/,
+                           Vector<int>& /*n_cycle*/,
+                           const Vector<IntVect>& /*ref_ratio*/,
+                           Vector<Real>& dt_level, Real /*stop_time*/) override
+    {
+        for (int lev = 0; lev <= finest_level; ++lev) { dt_level[lev] = fixed_dt; }
+    }
+
+    void computeNewDt (int finest_level, int /*sub_cycle*/,
+                       Vector<int>& /*n_cycle*/,
+                       const Vector<IntVect>& /*ref_ratio*/,
+                       Vector<Real>& /*dt_min*/, Vector<Real>& dt_level,
+                       Real /*stop_time*/, int /*post_regrid_flag*/) override
+    {
+        for (int lev = 0; lev <= finest_level; ++lev) { dt_level[lev] = fixed_dt; }
+    }
+
+    Real advance (Real /*time*/, Real dt, int /*iteration*/, int /*ncycle*/) override
+    {
+        state[0].allocOldData();
+        state[0].swapTimeLevels(dt);
+
+        MultiFab& S_new = get_new_data(0);
+        MultiFab const& S_old = get_old_data(0);
+        const auto problo = geom.ProbLoArray();
+        const auto dx = geom.CellSizeArray();
+        auto const& snew = S_new.arrays();
+        auto const& sold = S_old.const_arrays();
+        amrex::ParallelFor(S_new, [=] AMREX_GPU_DEVICE (int b, int i, int j, int k) noexcept
+        {
+            const Real x = problo[0] + (Real(i)+Real(0.5))*dx[0];
+            snew[b](i,j,k) = sold[b](i,j,k) + dt*source(x);
+        });
+        Gpu::streamSynchronize();
+
+        m_advanced_grids = grids;
+        if (level == 0) { setPostStepRegrid(1); }
+        return dt;
+    }
+
+    void post_timestep (int /*iteration*/) override
+    {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_advanced_grids == grids,
+                                         "post_timestep is not on the advanced grids");
+        if (level < parent->finestLevel()) {
+            averageDownFrom(level+1);
+        }
+    }
+
+    void post_regrid (int /*lbase*/, int /*new_finest*/) override {}
+
+    void post_init (Real /*stop_time*/) override
+    {
+        if (level == 0) {
+            for (int lev = parent->finestLevel(); lev > 0; --lev) {
+                getLevel(lev-1).averageDownFrom(lev);
+            }
+        }
+    }
+
+    void initData () override
+    {
+        MultiFab& S_new = get_new_data(0);
+        const auto problo = geom.ProbLoArray();
+        const auto dx = geom.CellSizeArray();
+        auto const& snew = S_new.arrays();
+        amrex::ParallelFor(S_new, [=] AMREX_GPU_DEVICE (int b, int i, int j, int k) noexcept
+        {
+            snew[b](i,j,k) = problo[0] + (Real(i)+Real(0.5))*dx[0];
+        });
+        Gpu::streamSynchronize();
+    }
+
+    void init (AmrLevel& old) override
+    {
+        const Real cur_time = old.get_state_data(0).curTime();
+        const Real prev_time = old.get_state_data(0).prevTime();
+        setTimeLevel(cur_time, cur_time-prev_time, parent->dtLevel(level));
+        FillPatch(old, get_new_data(0), 0, cur_time, 0, 0, 1);
+    }
+
+    void init () override
+    {
+        const Real cur_time = getLevel(level-1).get_state_data(0).curTime();
+        const Real prev_time = getLevel(level-1).get_state_data(0).prevTime();
+        setTimeLevel(cur_time, cur_time-prev_time, parent->dtLevel(level));
+        FillCoarsePatch(get_new_data(0), 0, cur_time, 0, 0, 1);
+    }
+
+    void errorEst (TagBoxArray& tags, int /*clearval*/, int /*tagval*/, Real time,
+                   int /*n_error_buf*/, int /*ngrow*/) override
+    {
+        const auto problo = geom.ProbLoArray();
+        const auto dx = geom.CellSizeArray();
+        auto const& ta = tags.arrays();
+        amrex::ParallelFor(tags, [=] AMREX_GPU_DEVICE (int b, int i, int j, int k) noexcept
+        {
+            if (tagged(problo[0] + (Real(i)+Real(0.5))*dx[0], time)) {
+                ta[b](i,j,k) = TagBox::SET;
+            }
+        });
+        Gpu::streamSynchronize();
+    }
+
+private:
+
+    SyncLevel& getLevel (int lev) { return static_cast<SyncLevel&>(parent->getLevel(lev)); }
+
+    void averageDownFrom (int lev_fine)
+    {
+        auto& fine = getLevel(lev_fine);
+        amrex::average_down(fine.get_new_data(0), get_new_data(0), fine.geom, geom,
+                            0, 1, parent->refRatio(level));
+    }
+
+    BoxArray m_advanced_grids;
+};
+
+class SyncLevelBld
+    :
+    public LevelBld
+{
+    void variableSetUp () override { SyncLevel::variableSetUp(); }
+    void variableCleanUp () override { SyncLevel::variableCleanUp(); }
+    AmrLevel* operator() () override { return new SyncLevel; }
+    AmrLevel* operator() (Amr& papa, int lev, const Geometry& level_geom,
+                          const BoxArray& ba, const DistributionMapping& dm,
+                          Real time) override
+    {
+        return new SyncLevel(papa, lev, level_geom, ba, dm, time);
+    }
+};
+
+struct RunResult
+{
+    Vector<BoxArray> grids;
+    Vector<MultiFab> phi;
+    int ngrid_changes = 0;
+};
+
+RunResult run (std::string const& mode, int max_step)
+{
+    {
+        ParmParse pp("amr");
+        pp.add("subcycling_mode", mode);
+    }
+
+    SyncLevelBld bld;
+    Amr amr(&bld);
+    amr.init(Real(0.), Real(-1.));
+
+    RunResult r;
+    BoxArray fine_grids = amr.boxArray(amr.finestLevel());
+    while (amr.levelSteps(0) < max_step) {
+        amr.coarseTimeStep(Real(-1.));
+        if (amr.boxArray(amr.finestLevel()) != fine_grids) {
+            fine_grids = amr.boxArray(amr.finestLevel());
+            ++r.ngrid_changes;
+        }
+    }
+
+    for (int lev = 0; lev <= amr.finestLevel(); ++lev) {
+        MultiFab const& phi = amr.getLevel(lev).get_new_data(0);
+        r.grids.push_back(phi.boxArray());
+        r.phi.emplace_back(phi.boxArray(), phi.DistributionMap(), 1, 0);
+        MultiFab::Copy(r.phi.back(), phi, 0, 0, 1, 0);
+    }
+    return r;
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int max_step = 8;
+        {
+            ParmParse pp;
+            pp.query("max_step", max_step);
+            ParmParse ppsync("sync");
+            ppsync.query("dt", fixed_dt);
+        }
+
+        RunResult none = run("None", max_step);
+        RunResult sync = run("Synchronous", max_step);
+
+        AMREX_ALWAYS_ASSERT(none.grids.size() == 2);
+        AMREX_ALWAYS_ASSERT(none.ngrid_changes > 1 && sync.ngrid_changes == none.ngrid_changes);
+        AMREX_ALWAYS_ASSERT(none.grids.size() == sync.grids.size());
+
+        Real max_diff = 0;
+        for (int lev = 0; lev < none.grids.size(); ++lev) {
+            AMREX_ALWAYS_ASSERT(none.grids[lev] == sync.grids[lev]);
+            MultiFab diff(sync.phi[lev].boxArray(), sync.phi[lev].DistributionMap(), 1, 0);
+            diff.ParallelCopy(none.phi[lev]);
+            MultiFab::Subtract(diff, sync.phi[lev], 0, 0, 1, 0);
+            max_diff = std::max(max_diff, diff.norminf() / none.phi[lev].norminf());
+        }
+        amrex::Print() << "Grids changed " << none.ngrid_changes << " times, "
+                       << "max relative difference between None and Synchronous: "
+                       << max_diff << "\n";
+        AMREX_ALWAYS_ASSERT(max_diff < Real(1.e-12));
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,235 @@
+//
+// Checks TagBoxArray::buffer, which dilates the tags as bit masks, against
+// a per-cell search of the neighbors, and checks the buffered tags after
+// mapPeriodicRemoveDuplicates against a dilation of the tags over the
+// whole domain, which is periodic in all directions but the last one.
+//
+
+#include <AMReX.H>
+#include <AMReX_Geometry.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_TagBox.H>
+
+#include <random>
+
+using namespace amrex;
+
+namespace {
+
+struct TestParams
+{
+    int n_cell = 72;
+    int max_grid_size = 16;
+    IntVect n_buf{AMREX_D_DECL(3,1,2)};
+    int ntags = 300;
+};
+
+// The cells tagged in the whole domain, the same on all processes
+Vector<IntVect> make_tags (Box const& domain, int ntags)
+{
+    std::mt19937 gen(4321);
+    Vector<IntVect> tags;
+    for (int n = 0; n < ntags; ++n) {
+        IntVect iv;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            std::uniform_int_distribution<int> dist(domain.smallEnd(idim), domain.bigEnd(idim));
+            iv[idim] = dist(gen);
+        }
+        tags.push_back(iv);
+    }
+    // Make sure that some tags are buffered across the domain boundaries.
+    tags.push_back(domain.smallEnd());
+    tags.push_back(domain.bigEnd());
+    return tags;
+}
+
+void set_tags (TagBoxArray& tba, Vector<IntVect> const& tags)
+{
+    tba.setVal(TagBox::CLEAR);
+    for (MFIter mfi(tba); mfi.isValid(); ++mfi) {
+        Box const& vbx = mfi.validbox();
+        Vector<IntVect> local_tags;
+        for (auto const& iv : tags) {
+            if (vbx.contains(iv)) { local_tags.push_back(iv); }
+        }
+        const int n = static_cast<int>(local_tags.size());
+        if (n == 0) { continue; }
+        Gpu::DeviceVector<IntVect> d_tags(n);
+        Gpu::copyAsync(Gpu::hostToDevice, local_tags.begin(), local_tags.end(), d_tags.begin());
+        auto const* p = d_tags.data();
+        auto const& a = tba.array(mfi);
+        amrex::ParallelFor(n, [=] AMREX_GPU_DEVICE (int i) noexcept
+        {
+            a(p[i]) = TagBox::SET;
+        });
+        Gpu::streamSynchronize();
+    }
+}
+
+// The original algorithm: a CLEAR cell becomes BUF if there is a SET cell
+// in the interior within nbuf of it.
+void buffer_per_cell (TagBoxArray& tba, IntVect const& nbuf)
+{
+    const Dim3 nb = nbuf.dim3();
+    for (MFIter mfi(tba); mfi.isValid(); ++mfi) {
+        Box const& interior = mfi.validbox();
+        const auto lo = amrex::lbound(interior);
+        const auto hi = amrex::ubound(interior);
+        auto const& a = tba.array(mfi);
+        amrex::ParallelFor(mfi.fabbox(), [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            if (a(i,j,k) == TagBox::CLEAR) {
+                bool to_buf = false;
+                for (int kk = amrex::max(k-nb.z,lo.z); kk <= amrex::min(k+nb.z,hi.z) && !to_buf; ++kk) {
+                for (int jj = amrex::max(j-nb.y,lo.y); jj <= amrex::min(j+nb.y,hi.y) && !to_buf; ++jj) {
+                for (int ii = amrex::max(i-nb.x,lo.x); ii <= amrex::min(i+nb.x,hi.x) && !to_buf; ++ii) {
+                    if (a(ii,jj,kk) == TagBox::SET) { to_buf = true; }
+                }}}
+                if (to_buf) { a(i,j,k) = TagBox::BUF; }
+            }
+        });
+    }
+    Gpu::streamSynchronize();
+}
+
+// Number of cells, including ghost cells, where a and b differ
+Long count_diff (TagBoxArray const& a, TagBoxArray const& b)
+{
+    ReduceOps<ReduceOpSum> reduce_op;
+    ReduceData<Long> reduce_data(reduce_op);
+    for (MFIter mfi(a); mfi.isValid(); ++mfi) {
+        auto const& aa = a.const_array(mfi);
+        auto const& ba = b.const_array(mfi);
+        reduce_op.eval(mfi.fabbox(), reduce_data,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k) -> GpuTuple<Long>
+        {
+            return { Long(aa(i,j,k) != ba(i,j,k)) };
+        });
+    }
+    Long n = amrex::get<0>(reduce_data.value(reduce_op));
+    ParallelDescriptor::ReduceLongSum(n);
+    return n;
+}
+
+// After mapPeriodicRemoveDuplicates, a tag can be in a valid cell or in a
+// ghost cell.  Returns the number of cells of the domain where the tags,
+// mapped through the periodic boundaries, differ from the tags dilated by
+// nbuf modulo the periodicity, plus the number of cells of the domain
+// that are tagged more than once without the periodic mapping.
+Long count_diff_periodic (TagBoxArray const& tba, Geometry const& geom,
+                          Vector<IntVect> const& tags, IntVect const& nbuf)
+{
+    Box const& domain = geom.Domain();
+
+    // Periodic image of iv in the domain, or false if there is none
+    auto map_to_domain = [&] (IntVect& iv) -> bool
+    {
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            const int n = domain.length(idim);
+            if (geom.isPeriodic(idim)) {
+                iv[idim] = domain.smallEnd(idim)
+                    + ((iv[idim] - domain.smallEnd(idim)) % n + n) % n;
+            } else if (iv[idim] < domain.smallEnd(idim) || iv[idim] > domain.bigEnd(idim)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    BaseFab<int> expected(domain, 1, The_Pinned_Arena());
+    expected.setVal<RunOn::Host>(0);
+    for (auto const& tag : tags) {
+        Box bx = amrex::grow(Box(tag,tag), nbuf);
+        for (BoxIterator bi(bx); bi.ok(); ++bi) {
+            IntVect iv = bi();
+            if (map_to_domain(iv)) { expected(iv) = 1; }
+        }
+    }
+
+    // Component 0: tagged through the periodic mapping,
+    // component 1: number of times tagged without it
+    BaseFab<int> found(domain, 2, The_Pinned_Arena());
+    found.setVal<RunOn::Host>(0);
+    for (MFIter mfi(tba); mfi.isValid(); ++mfi) {
+        Box const& fbx = mfi.fabbox();
+        TagBox host_tags(fbx, 1, The_Pinned_Arena());
+        host_tags.copy<RunOn::Device>(tba[mfi], fbx);
+        Gpu::streamSynchronize();
+        for (BoxIterator bi(fbx); bi.ok(); ++bi) {
+            if (host_tags(bi()) == TagBox::CLEAR) { continue; }
+            if (domain.contains(bi())) { found(bi(), 1) += 1; }
+            IntVect iv = bi();
+            if (map_to_domain(iv)) { found(iv, 0) = 1; }
+        }
+    }
+    ParallelDescriptor::ReduceIntSum(found.dataPtr(), static_cast<int>(found.size()));
+
+    Long ndiff = 0;
+    for (BoxIterator bi(domain); bi.ok(); ++bi) {
+        if ((found(bi(),0) != 0) != (expected(bi()) != 0)) { ++ndiff; }
+        if (found(bi(),1) > 1) { ++ndiff; }
+    }
+    return ndiff;
+}
+
+void test_buffer (TestParams const& p, int max_grid_size)
+{
+    const Box domain(IntVect(0), IntVect(p.n_cell-1));
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    // Periodic in all directions but the last one
+    Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(1,1,1)};
+    is_periodic[AMREX_SPACEDIM-1] = (AMREX_SPACEDIM > 1) ? 0 : 1;
+    Geometry geom(domain, rb, CoordSys::cartesian, is_periodic);
+
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    const auto tags = make_tags(domain, p.ntags);
+
+    TagBoxArray tba(ba, dm, p.n_buf);
+    TagBoxArray tba_ref(ba, dm, p.n_buf);
+    set_tags(tba, tags);
+    set_tags(tba_ref, tags);
+
+    tba.buffer(p.n_buf);
+    buffer_per_cell(tba_ref, p.n_buf);
+
+    const Long ndiff = count_diff(tba, tba_ref);
+    amrex::Print() << "max_grid_size " << max_grid_size << ": " << ndiff
+                   << " cells differ from the per-cell buffer\n";
+    AMREX_ALWAYS_ASSERT(ndiff == 0);
+
+    tba.mapPeriodicRemoveDuplicates(geom);
+    const Long ndiff_periodic = count_diff_periodic(tba, geom, tags, p.n_buf);
+    amrex::Print() << "max_grid_size " << max_grid_size << ": " << ndiff_periodic
+                   << " cells differ from the periodic dilation\n";
+    AMREX_ALWAYS_ASSERT(ndiff_periodic == 0);
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        TestParams p;
+        {
+            ParmParse pp;
+            pp.query("n_cell", p.n_cell);
+            pp.query("max_grid_size", p.max_grid_size);
+            Vector<int> nbuf;
+            if (pp.queryarr("n_buf", nbuf, 0, AMREX_SPACEDIM)) {
+                p.n_buf = IntVect(nbuf);
+            }
+            pp.query("ntags", p.ntags);
+        }
+
+        // Small boxes, with tags buffered into the ghost cells of many
+        // boxes, and a single box, longer than a 64-bit word in x.
+        test_buffer(p, p.max_grid_size);
+        test_buffer(p, p.n_cell);
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,199 @@
+//
+// Checks the conservative WENO-AO(5,3) interpolater, mf_weno_interp, on
+// exact cell averages.  All the stencils of the scheme are exact for
+// quadratics, so the interpolation of a polynomial of degree two in each
+// direction must be exact whatever the nonlinear weights are.  On a smooth
+// field the error must converge at high order.  The destination domain
+// also leaves some fine boxes with nothing to fill, which must be skipped.
+//
+
+#include <AMReX.H>
+#include <AMReX_MFInterpolater.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <cmath>
+
+using namespace amrex;
+
+namespace {
+
+struct TestParams
+{
+    int n_cell = 16;
+    int max_grid_size = 8;
+};
+
+enum struct Field { quadratic, smooth };
+
+constexpr Real untouched = Real(1.e200);
+
+// Exact average over the cell [lo,hi] of the sum of x^a*y^b*z^c/(1+a+2b+3c)
+// for a,b,c <= 2, or of the product of sines.
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+Real cell_average (Field field, GpuArray<Real,AMREX_SPACEDIM> const& lo,
+                   GpuArray<Real,AMREX_SPACEDIM> const& hi) noexcept
+{
+    if (field == Field::quadratic) {
+        Real mom[AMREX_SPACEDIM][3];
+        int nterms = 1;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            const Real a = lo[idim];
+            const Real b = hi[idim];
+            mom[idim][0] = Real(1.);
+            mom[idim][1] = Real(0.5)*(a+b);
+            mom[idim][2] = Real(1./3.)*(a*a+a*b+b*b);
+            nterms *= 3;
+        }
+        Real r = 0;
+        for (int t = 0; t < nterms; ++t) {
+            Real term = 1;
+            int denom = 1;
+            for (int idim = 0, e = t; idim < AMREX_SPACEDIM; ++idim, e /= 3) {
+                term *= mom[idim][e%3];
+                denom += (idim+1)*(e%3);
+            }
+            r += term/Real(denom);
+        }
+        return r;
+    } else {
+        constexpr Real w = Real(2.)*Math::pi<Real>();
+        Real r = 1;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            const Real ph = Real(0.3) + Real(0.7)*idim;
+            r *= (std::cos(w*lo[idim]+ph) - std::cos(w*hi[idim]+ph)) / (w*(hi[idim]-lo[idim]));
+        }
+        return r;
+    }
+}
+
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+Real cell_average (Field field, IntVect const& iv, GpuArray<Real,AMREX_SPACEDIM> const& dx) noexcept
+{
+    GpuArray<Real,AMREX_SPACEDIM> lo, hi;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        lo[idim] = Real(iv[idim])*dx[idim];
+        hi[idim] = Real(iv[idim]+1)*dx[idim];
+    }
+    return cell_average(field, lo, hi);
+}
+
+struct Result
+{
+    Real max_error = 0;
+    Long nchanged = 0;  // cells outside the destination domain that were changed
+    int nskipped = 0;   // fine boxes with nothing to fill
+};
+
+// Interpolates the cell averages of field on fine grids that cover the
+// middle of the domain, into the part of them in dest_domain.  If partial,
+// dest_domain stops at 3/8 of the domain in the first direction, which is
+// inside the first fine boxes and leaves the last ones with nothing to fill.
+Result test_interp (TestParams const& p, int n_cell, IntVect const& ratio, Field field,
+                    bool partial)
+{
+    const Box cdomain(IntVect(0), IntVect(n_cell-1));
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,0)};
+    Geometry cgeom(cdomain, rb, CoordSys::cartesian, is_periodic);
+    Geometry fgeom(amrex::refine(cdomain,ratio), rb, CoordSys::cartesian, is_periodic);
+
+    Box dest_domain = fgeom.Domain();
+    if (partial) {
+        dest_domain.setBig(0, ratio[0]*(3*n_cell/8)-1);
+    }
+
+    const IntVect ng(1);
+    BoxArray fba(amrex::refine(Box(IntVect(n_cell/4), IntVect(3*n_cell/4-1)), ratio));
+    fba.maxSize(p.max_grid_size);
+    DistributionMapping dm(fba);
+
+    BoxList cbl;
+    Result r;
+    for (int i = 0, N = static_cast<int>(fba.size()); i < N; ++i) {
+        cbl.push_back(mf_weno_interp.CoarseBox(amrex::grow(fba[i],ng), ratio));
+        if (!(amrex::grow(fba[i],ng) & dest_domain).ok()) { ++r.nskipped; }
+    }
+
+    MultiFab crse(BoxArray(std::move(cbl)), dm, 1, 0);
+    const auto cdx = cgeom.CellSizeArray();
+    auto const& ca = crse.arrays();
+    ParallelFor(crse, [=] AMREX_GPU_DEVICE (int b, int i, int j, int k) noexcept
+    {
+        ca[b](i,j,k) = cell_average(field, IntVect(AMREX_D_DECL(i,j,k)), cdx);
+    });
+
+    MultiFab fine(fba, dm, 1, ng);
+    fine.setVal(untouched);
+
+    Vector<BCRec> bcs(1);
+    mf_weno_interp.interp(crse, 0, fine, 0, 1, ng, cgeom, fgeom, dest_domain, ratio, bcs, 0);
+
+    const auto fdx = fgeom.CellSizeArray();
+    ReduceOps<ReduceOpMax, ReduceOpSum> reduce_op;
+    ReduceData<Real, Long> reduce_data(reduce_op);
+    for (MFIter mfi(fine); mfi.isValid(); ++mfi) {
+        auto const& fa = fine.const_array(mfi);
+        reduce_op.eval(mfi.fabbox(), reduce_data,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k) -> GpuTuple<Real,Long>
+        {
+            const IntVect iv(AMREX_D_DECL(i,j,k));
+            if (dest_domain.contains(iv)) {
+                return { std::abs(fa(i,j,k) - cell_average(field, iv, fdx)), 0 };
+            } else {
+                return { Real(0.), Long(fa(i,j,k) != untouched) };
+            }
+        });
+    }
+    auto hv = reduce_data.value(reduce_op);
+    r.max_error = amrex::get<0>(hv);
+    r.nchanged = amrex::get<1>(hv);
+    ParallelDescriptor::ReduceRealMax(r.max_error);
+    ParallelDescriptor::ReduceLongSum(r.nchanged);
+    return r;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        TestParams p;
+        {
+            ParmParse pp;
+            pp.query("n_cell", p.n_cell);
+            pp.query("max_grid_size", p.max_grid_size);
+        }
+
+        for (auto const& ratio : {IntVect(2), IntVect(AMREX_D_DECL(4,2,3))}) {
+            auto r = test_interp(p, p.n_cell, ratio, Field::quadratic, false);
+            amrex::Print() << "Quadratic, ratio " << ratio << ": max error " << r.max_error << "\n";
+            AMREX_ALWAYS_ASSERT(r.max_error < Real(1.e-13));
+        }
+
+        {
+            auto r = test_interp(p, p.n_cell, IntVect(2), Field::quadratic, true);
+            amrex::Print() << "Quadratic, part of the domain: max error " << r.max_error
+                           << ", " << r.nskipped << " boxes with nothing to fill, "
+                           << r.nchanged << " cells changed outside\n";
+            AMREX_ALWAYS_ASSERT(r.nskipped > 0 && r.nchanged == 0);
+            AMREX_ALWAYS_ASSERT(r.max_error < Real(1.e-13));
+        }
+
+        Real err_prev = 0;
+        for (int n = p.n_cell; n <= 4*p.n_cell; n *= 2) {
+            auto r = test_interp(p, n, IntVect(2), Field::smooth, false);
+            amrex::Print() << "Smooth, n_cell " << n << ": max error " << r.max_error;
+            if (n > p.n_cell) {
+                const Real order = std::log2(err_prev/r.max_error);
+                amrex::Print() << ", order " << order;
+                AMREX_ALWAYS_ASSERT(order > Real(4.5));
+            }
+            amrex::Print() << "\n";
+            err_prev = r.max_error;
+        }
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,169 @@
+//
+// Solves several right-hand sides at once with a multi-component
+// MLABecLaplacian and MLMG::setComponentwiseConvergence, on one and on two
+// AMR levels, and compares the number of iterations of each component
+// with a solve of that component alone.  The components are decoupled and
+// the bottom solver is the smoother, so each component must converge at
+// exactly the same iteration as its own solve.  The right-hand sides are
+// chosen so that the components converge at different iterations, and one
+// of them is zero and needs no iteration.
+//
+
+#include <AMReX.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+namespace {
+
+struct TestParams
+{
+    int n_cell = 32;
+    int max_grid_size = 16;
+    Real reltol = Real(1.e-10);
+    int verbose = 0;
+};
+
+constexpr int ncomp = 4;
+
+// Component 0 is smooth, 1 is rough and large, 2 is a narrow bump and 3 is zero.
+void init_rhs (MultiFab& rhs, Geometry const& geom, int comp0)
+{
+    const auto problo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    const Real pi = Real(3.14159265358979323846);
+    auto const& ma = rhs.arrays();
+    ParallelFor(rhs, IntVect(0), rhs.nComp(),
+    [=] AMREX_GPU_DEVICE (int b, int i, int j, int k, int m) noexcept
+    {
+        AMREX_D_TERM(Real x = problo[0] + (Real(i)+Real(0.5))*dx[0];,
+                     Real y = problo[1] + (Real(j)+Real(0.5))*dx[1];,
+                     Real z = problo[2] + (Real(k)+Real(0.5))*dx[2];);
+        Real r2 = AMREX_D_TERM((x-Real(0.4))*(x-Real(0.4)), + (y-Real(0.5))*(y-Real(0.5)),
+                               + (z-Real(0.6))*(z-Real(0.6)));
+        Real v = 0;
+        switch (comp0 + m) {
+        case 0:
+            v = AMREX_D_TERM(std::sin(pi*x), *std::sin(pi*y), *std::sin(pi*z));
+            break;
+        case 1:
+            v = Real(1.e3) * AMREX_D_TERM(std::sin(Real(13.)*pi*x), *std::cos(Real(7.)*pi*y),
+                                          *std::sin(Real(11.)*pi*z));
+            break;
+        case 2:
+            v = Real(1.e-3) * std::exp(-r2/Real(0.002));
+            break;
+        default:
+            break;
+        }
+        ma[b](i,j,k,m) = v;
+    });
+    Gpu::streamSynchronize();
+}
+
+// Solves the components [comp0,comp0+nc) of the problem at once and
+// returns the number of iterations of each component.
+Vector<int> solve (TestParams const& p, int nlevels, int comp0, int nc)
+{
+    Vector<Geometry> geom(nlevels);
+    Vector<BoxArray> grids(nlevels);
+    Vector<DistributionMapping> dmap(nlevels);
+
+    Box domain(IntVect(0), IntVect(p.n_cell-1));
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    for (int lev = 0; lev < nlevels; ++lev) {
+        geom[lev].define(domain, rb, CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+        if (lev == 0) {
+            grids[lev].define(domain);
+        } else {
+            // The middle of the domain
+            grids[lev].define(amrex::grow(domain, -p.n_cell/4));
+        }
+        grids[lev].maxSize(p.max_grid_size);
+        dmap[lev].define(grids[lev]);
+        domain.refine(2);
+    }
+
+    MLABecLaplacian mlabec(geom, grids, dmap, LPInfo(), {}, nc);
+    mlabec.setDomainBC({AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet)},
+                       {AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet)});
+    mlabec.setScalars(Real(1.), Real(1.));
+
+    Vector<MultiFab> sol(nlevels);
+    Vector<MultiFab> rhs(nlevels);
+    for (int lev = 0; lev < nlevels; ++lev) {
+        sol[lev].define(grids[lev], dmap[lev], nc, 1);
+        sol[lev].setVal(Real(0.));
+        rhs[lev].define(grids[lev], dmap[lev], nc, 0);
+        init_rhs(rhs[lev], geom[lev], comp0);
+        mlabec.setLevelBC(lev, &sol[lev]);
+        mlabec.setACoeffs(lev, Real(1.));
+        mlabec.setBCoeffs(lev, Real(1.));
+    }
+
+    MLMG mlmg(mlabec);
+    mlmg.setVerbose(p.verbose);
+    mlmg.setMaxIter(100);
+    // A bottom solver that does not couple the components
+    mlmg.setBottomSolver(MLMG::BottomSolver::smoother);
+    mlmg.setComponentwiseConvergence(true);
+    mlmg.solve(GetVecOfPtrs(sol), GetVecOfConstPtrs(rhs), p.reltol, Real(0.));
+
+    if (nc == 1) {
+        return {mlmg.getNumIters()};
+    } else {
+        return mlmg.getNumItersComp();
+    }
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        TestParams p;
+        {
+            ParmParse pp;
+            pp.query("n_cell", p.n_cell);
+            pp.query("max_grid_size", p.max_grid_size);
+            pp.query("reltol", p.reltol);
+            pp.query("verbose", p.verbose);
+        }
+
+        for (int nlevels : {1, 2}) {
+            const auto niters = solve(p, nlevels, 0, ncomp);
+            AMREX_ALWAYS_ASSERT(niters.size() == ncomp);
+            amrex::Print() << nlevels << " AMR level(s), iterations per component:";
+            for (int n = 0; n < ncomp; ++n) {
+                amrex::Print() << " " << niters[n];
+            }
+            amrex::Print() << "\n";
+
+            int min_iters = niters[0];
+            int max_iters = niters[0];
+            for (int n = 0; n < ncomp; ++n) {
+                const auto niters_alone = solve(p, nlevels, n, 1);
+                amrex::Print() << "  component " << n << " alone: " << niters_alone[0] << "\n";
+                AMREX_ALWAYS_ASSERT(niters[n] == niters_alone[0]);
+                if (n < ncomp-1) {
+                    min_iters = std::min(min_iters, niters[n]);
+                    max_iters = std::max(max_iters, niters[n]);
+                }
+            }
+            // The zero right-hand side needs no iteration, and the others do
+            // not all converge together.
+            AMREX_ALWAYS_ASSERT(niters[ncomp-1] == 0);
+            AMREX_ALWAYS_ASSERT(min_iters > 0 && min_iters < max_iters);
+        }
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,260 @@
+//
+// Checks the 1D FFT against a direct DFT, FFTPoisson against analytic
+// solutions, with periodic boundaries and with open boundaries, and MLMG
+// with the FFT bottom solver against FFTPoisson.
+//
+
+#include <AMReX.H>
+#include <AMReX_FFT.H>
+#include <AMReX_FFTPoisson.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_MLPoisson.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <complex>
+#include <limits>
+
+using namespace amrex;
+
+namespace {
+
+struct TestParams
+{
+    int n_cell = 32;
+    int max_grid_size = 16;
+    int verbose = 0;
+};
+
+constexpr Real pi = Real(3.14159265358979323846);
+
+// phi = prod sin(2 pi k_d x_d + d), so that lap(phi) = -|2 pi k|^2 phi
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+Real periodic_phi (Real x, Real y, Real z) noexcept
+{
+    amrex::ignore_unused(y,z);
+    return AMREX_D_TERM(  std::sin(Real(2.)*pi*x),
+                        * std::sin(Real(4.)*pi*y + Real(1.)),
+                        * std::sin(Real(2.)*pi*z + Real(2.)));
+}
+
+constexpr Real periodic_k2 = AMREX_D_TERM(Real(4.)*pi*pi, + Real(16.)*pi*pi, + Real(4.)*pi*pi);
+
+// A Gaussian of width sigma centered in the unit cube, whose potential
+// in free space is -M erf(r/sigma) / (4 pi r).
+constexpr Real gauss_sigma = Real(0.1);
+
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+Real gauss_r (Real x, Real y, Real z) noexcept
+{
+    amrex::ignore_unused(y,z);
+    return std::sqrt(AMREX_D_TERM((x-Real(0.5))*(x-Real(0.5)),
+                                  + (y-Real(0.5))*(y-Real(0.5)),
+                                  + (z-Real(0.5))*(z-Real(0.5))));
+}
+
+// Maximum difference between Plan1D and a direct DFT, relative to the
+// largest output, over both directions.
+Real check_plan1d (int n)
+{
+    using C = std::complex<Real>;
+    FFT::Plan1D plan(n);
+    Vector<C> x(n), work(plan.workSize());
+    for (int j = 0; j < n; ++j) {
+        x[j] = C(std::cos(Real(0.3)*j*j + Real(1.)), std::sin(Real(0.7)*j));
+    }
+    Real err = 0;
+    for (bool inverse : {false, true}) {
+        Vector<C> y = x;
+        if (inverse) {
+            plan.backward(y.data(), work.data());
+        } else {
+            plan.forward(y.data(), work.data());
+        }
+        const Real sign = inverse ? Real(1.) : Real(-1.);
+        Real ymax = 0, dmax = 0;
+        for (int k = 0; k < n; ++k) {
+            C z = 0;
+            for (int j = 0; j < n; ++j) {
+                const double theta = sign * 2.0 * 3.14159265358979323846
+                    * double((Long(j)*k) % n) / double(n);
+                z += x[j] * C(Real(std::cos(theta)), Real(std::sin(theta)));
+            }
+            ymax = std::max(ymax, std::abs(z));
+            dmax = std::max(dmax, std::abs(z - y[k]));
+        }
+        err = std::max(err, dmax/ymax);
+    }
+    return err;
+}
+
+template <typename F>
+void fill (MultiFab& mf, Geometry const& geom, F const& f)
+{
+    const auto problo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    auto const& ma = mf.arrays();
+    ParallelFor(mf, [=] AMREX_GPU_DEVICE (int b, int i, int j, int k) noexcept
+    {
+        amrex::ignore_unused(j,k);
+        Real x = problo[0] + (Real(i)+Real(0.5))*dx[0];
+        Real y = (AMREX_SPACEDIM >= 2) ? problo[1] + (Real(j)+Real(0.5))*dx[1] : Real(0.);
+        Real z = (AMREX_SPACEDIM == 3) ? problo[2] + (Real(k)+Real(0.5))*dx[2] : Real(0.);
+        ma[b](i,j,k) = f(x,y,z);
+    });
+    Gpu::streamSynchronize();
+}
+
+Real max_error (MultiFab const& sol, MultiFab const& exact)
+{
+    MultiFab err(sol.boxArray(), sol.DistributionMap(), 1, 0);
+    MultiFab::Copy(err, sol, 0, 0, 1, 0);
+    MultiFab::Subtract(err, exact, 0, 0, 1, 0);
+    return err.norminf() / exact.norminf();
+}
+
+Geometry make_geom (int n_cell, int is_periodic)
+{
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    Array<int,AMREX_SPACEDIM> periodic{AMREX_D_DECL(is_periodic,is_periodic,is_periodic)};
+    return Geometry(Box(IntVect(0), IntVect(n_cell-1)), rb, CoordSys::cartesian, periodic);
+}
+
+// Returns the relative error of the periodic solution.
+Real solve_periodic (TestParams const& p, int n_cell)
+{
+    Geometry geom = make_geom(n_cell, 1);
+    BoxArray ba(geom.Domain());
+    ba.maxSize(p.max_grid_size);
+    DistributionMapping dm(ba);
+
+    MultiFab rhs(ba, dm, 1, 0), sol(ba, dm, 1, 0), exact(ba, dm, 1, 0);
+    fill(exact, geom, [=] AMREX_GPU_DEVICE (Real x, Real y, Real z) noexcept
+                      { return periodic_phi(x,y,z); });
+    fill(rhs, geom, [=] AMREX_GPU_DEVICE (Real x, Real y, Real z) noexcept
+                    { return -periodic_k2 * periodic_phi(x,y,z); });
+
+    FFTPoisson fft(geom, ba, dm, FFTPoisson::BC::periodic);
+    fft.setVerbose(p.verbose);
+    fft.solve(sol, rhs);
+    return max_error(sol, exact);
+}
+
+// Returns the relative error of the open boundary solution.
+Real solve_open (TestParams const& p, int n_cell)
+{
+    Geometry geom = make_geom(n_cell, 0);
+    BoxArray ba(geom.Domain());
+    ba.maxSize(p.max_grid_size);
+    DistributionMapping dm(ba);
+
+    const Real s2 = gauss_sigma*gauss_sigma;
+    const Real rho0 = Real(1.) / (std::sqrt(pi*pi*pi) * s2*gauss_sigma);  // M = 1
+    MultiFab rhs(ba, dm, 1, 0), sol(ba, dm, 1, 0), exact(ba, dm, 1, 0);
+    fill(rhs, geom, [=] AMREX_GPU_DEVICE (Real x, Real y, Real z) noexcept
+    {
+        Real r = gauss_r(x,y,z);
+        return rho0 * std::exp(-r*r/s2);
+    });
+    fill(exact, geom, [=] AMREX_GPU_DEVICE (Real x, Real y, Real z) noexcept
+    {
+        Real r = gauss_r(x,y,z);
+        return (r > Real(0.)) ? -std::erf(r/gauss_sigma) / (Real(4.)*pi*r)
+            : -Real(1.) / (Real(2.)*std::sqrt(pi*pi*pi)*gauss_sigma);
+    });
+
+    FFTPoisson fft(geom, ba, dm, FFTPoisson::BC::open);
+    fft.setVerbose(p.verbose);
+    fft.solve(sol, rhs);
+    return max_error(sol, exact);
+}
+
+// MLMG with the FFT bottom solver must reproduce the discrete solution of
+// FFTPoisson, up to the tolerance of MLMG.
+Real solve_mlmg_fft_bottom (TestParams const& p)
+{
+    Geometry geom = make_geom(p.n_cell, 1);
+    BoxArray ba(geom.Domain());
+    ba.maxSize(p.max_grid_size);
+    DistributionMapping dm(ba);
+
+    MultiFab rhs(ba, dm, 1, 0), sol(ba, dm, 1, 1), sol_fft(ba, dm, 1, 0);
+    fill(rhs, geom, [=] AMREX_GPU_DEVICE (Real x, Real y, Real z) noexcept
+                    { return -periodic_k2 * periodic_phi(x,y,z); });
+
+    MLPoisson mlpoisson({geom}, {ba}, {dm});
+    mlpoisson.setDomainBC({AMREX_D_DECL(LinOpBCType::Periodic,
+                                        LinOpBCType::Periodic,
+                                        LinOpBCType::Periodic)},
+                          {AMREX_D_DECL(LinOpBCType::Periodic,
+                                        LinOpBCType::Periodic,
+                                        LinOpBCType::Periodic)});
+    mlpoisson.setLevelBC(0, nullptr);
+
+    MLMG mlmg(mlpoisson);
+    mlmg.setBottomSolver(BottomSolver::fft);
+    mlmg.setVerbose(p.verbose);
+    sol.setVal(0.);
+    mlmg.solve({&sol}, {&rhs}, Real(1.e-12), Real(0.));
+
+    FFTPoisson fft(geom, ba, dm, FFTPoisson::BC::periodic);
+    fft.solve(sol_fft, rhs);
+
+    // The periodic solution is defined up to a constant.
+    MultiFab::Subtract(sol, sol_fft, 0, 0, 1, 0);
+    const Real offset = sol.sum(0) / Real(geom.Domain().numPts());
+    sol.plus(-offset, 0, 1, 0);
+    return sol.norminf(0, 0) / sol_fft.norminf(0, 0);
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        TestParams p;
+        {
+            ParmParse pp;
+            pp.query("n_cell", p.n_cell);
+            pp.query("max_grid_size", p.max_grid_size);
+            pp.query("verbose", p.verbose);
+        }
+
+        // Lengths that exercise each butterfly and their combinations
+        const Real tol = Real(1000.)*std::numeric_limits<Real>::epsilon();
+        for (int n : {1, 2, 3, 4, 5, 7, 8, 9, 12, 15, 25, 27, 30, 45, 49, 60, 77, 120, 125}) {
+            const Real err = check_plan1d(n);
+            if (err > tol) {
+                amrex::Print() << "Plan1D(" << n << "): relative error " << err << "\n";
+            }
+            AMREX_ALWAYS_ASSERT(err < tol);
+        }
+        amrex::Print() << "Plan1D agrees with the direct DFT\n";
+
+        // The discretization error is second order.
+        const Real err_periodic = solve_periodic(p, p.n_cell);
+        const Real err_periodic_2 = solve_periodic(p, 2*p.n_cell);
+        amrex::Print() << "Periodic: relative errors " << err_periodic << " and "
+                       << err_periodic_2 << " with " << p.n_cell << " and "
+                       << 2*p.n_cell << " cells\n";
+        AMREX_ALWAYS_ASSERT(err_periodic < Real(0.02));
+        AMREX_ALWAYS_ASSERT(err_periodic/err_periodic_2 > Real(3.5));
+
+#if (AMREX_SPACEDIM == 3)
+        const Real err_open = solve_open(p, p.n_cell);
+        const Real err_open_2 = solve_open(p, 2*p.n_cell);
+        amrex::Print() << "Open: relative errors " << err_open << " and "
+                       << err_open_2 << " with " << p.n_cell << " and "
+                       << 2*p.n_cell << " cells\n";
+        AMREX_ALWAYS_ASSERT(err_open < Real(0.02));
+        AMREX_ALWAYS_ASSERT(err_open/err_open_2 > Real(3.));
+#endif
+
+        const Real diff_mlmg = solve_mlmg_fft_bottom(p);
+        amrex::Print() << "MLMG with FFT bottom solver: relative difference " << diff_mlmg << "\n";
+        AMREX_ALWAYS_ASSERT(diff_mlmg < Real(1.e-9));
+    }
+    amrex::Finalize();
+}
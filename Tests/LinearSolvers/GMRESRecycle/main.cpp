@@ -0,0 +1,178 @@
+//
+// Solves a sequence of related systems A x_k = b_k with GMRES (MLMG as
+// preconditioner), once without and once with a recycled Krylov subspace,
+// and compares the cumulative number of GMRES iterations.  This is done
+// for a fixed operator, and for an operator whose alpha changes from one
+// solve to the next.
+//
+
+#include <AMReX.H>
+#include <AMReX_GMRES_MLMG.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+namespace {
+
+struct TestParams
+{
+    int n_cell = 64;
+    int max_grid_size = 32;
+    int nsolves = 12;
+    int recycle_size = 8;
+    int precond_niters = 1;
+    int verbose = 0;
+    Real ascalar_change = 500.;
+};
+
+void init_rhs (MultiFab& rhs, Geometry const& geom, int isolve)
+{
+    const auto problo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    // A smooth background that rotates in phase plus a moving bump.
+    const Real t = Real(0.15) * Real(isolve);
+    const Real xc = Real(0.3) + Real(0.03) * Real(isolve);
+    const Real pi = Real(3.14159265358979323846);
+    auto const& ma = rhs.arrays();
+    ParallelFor(rhs, [=] AMREX_GPU_DEVICE (int b, int i, int j, int k) noexcept
+    {
+        AMREX_D_TERM(Real x = problo[0] + (Real(i)+Real(0.5))*dx[0];,
+                     Real y = problo[1] + (Real(j)+Real(0.5))*dx[1];,
+                     Real z = problo[2] + (Real(k)+Real(0.5))*dx[2];);
+        Real r2 = AMREX_D_TERM((x-xc)*(x-xc), + (y-Real(0.5))*(y-Real(0.5)),
+                               + (z-Real(0.5))*(z-Real(0.5)));
+        Real v = std::sin(Real(2.)*pi*x + t) * std::cos(Real(2.)*pi*y - Real(0.5)*t)
+            + Real(10.) * std::exp(-r2/Real(0.01));
+#if (AMREX_SPACEDIM == 3)
+        v *= Real(1.) + Real(0.5)*std::sin(pi*z);
+#endif
+        ma[b](i,j,k) = v;
+    });
+    Gpu::streamSynchronize();
+}
+
+void init_bcoef (Array<MultiFab,AMREX_SPACEDIM>& bcoef, Geometry const& geom)
+{
+    const auto problo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        auto const& ma = bcoef[idim].arrays();
+        ParallelFor(bcoef[idim], [=] AMREX_GPU_DEVICE (int b, int i, int j, int k) noexcept
+        {
+            AMREX_D_TERM(Real x = problo[0] + Real(i)*dx[0];,
+                         Real y = problo[1] + Real(j)*dx[1];,
+                         Real z = problo[2] + Real(k)*dx[2];);
+            amrex::ignore_unused(AMREX_D_DECL(x,y,z));
+            ma[b](i,j,k) = Real(1.) + Real(100.) * AMREX_D_TERM(x*x, *y, *(Real(1.)-z));
+        });
+    }
+    Gpu::streamSynchronize();
+}
+
+// Returns the cumulative number of GMRES iterations of the sequence.
+int run_sequence (TestParams const& p, int recycle_size, Real ascalar_change,
+                  Vector<MultiFab>& solutions)
+{
+    Box domain(IntVect(0), IntVect(p.n_cell-1));
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    Geometry geom(domain, rb, CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+    BoxArray grids(domain);
+    grids.maxSize(p.max_grid_size);
+    DistributionMapping dmap(grids);
+
+    MLABecLaplacian mlabec({geom}, {grids}, {dmap});
+    mlabec.setDomainBC({AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet)},
+                       {AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet)});
+    mlabec.setLevelBC(0, nullptr);
+    mlabec.setScalars(Real(1.e-3), Real(1.));
+
+    Array<MultiFab,AMREX_SPACEDIM> bcoef;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        bcoef[idim].define(amrex::convert(grids, IntVect::TheDimensionVector(idim)),
+                           dmap, 1, 0);
+    }
+    init_bcoef(bcoef, geom);
+    mlabec.setACoeffs(0, Real(1.));
+    mlabec.setBCoeffs(0, GetArrOfConstPtrs(bcoef));
+
+    MLMG mlmg(mlabec);
+    GMRESMLMG gmsolver(mlmg);
+    gmsolver.setPrecondNumIters(p.precond_niters);
+    gmsolver.setPropertyOfZero(true); // homogeneous Dirichlet
+    gmsolver.setVerbose(p.verbose);
+    gmsolver.setRecycleSize(recycle_size);
+
+    MultiFab rhs(grids, dmap, 1, 0);
+
+    solutions.resize(p.nsolves);
+    int total_iters = 0;
+    for (int isolve = 0; isolve < p.nsolves; ++isolve) {
+        mlabec.setScalars(Real(1.e-3) + ascalar_change*Real(isolve), Real(1.));
+        init_rhs(rhs, geom, isolve);
+        solutions[isolve].define(grids, dmap, 1, 1);
+        solutions[isolve].setVal(Real(0.));
+        gmsolver.solve(solutions[isolve], rhs, Real(1.e-8), Real(0.));
+        AMREX_ALWAYS_ASSERT(gmsolver.getGMRES().getStatus() == 0);
+        total_iters += gmsolver.getNumIters();
+        amrex::Print() << "    solve " << isolve << ": iterations = "
+                       << gmsolver.getNumIters() << ", recycled vectors = "
+                       << gmsolver.getGMRES().getNumRecycleVectors() << "\n";
+    }
+    return total_iters;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        TestParams p;
+        {
+            ParmParse pp;
+            pp.query("n_cell", p.n_cell);
+            pp.query("max_grid_size", p.max_grid_size);
+            pp.query("nsolves", p.nsolves);
+            pp.query("recycle_size", p.recycle_size);
+            pp.query("precond_niters", p.precond_niters);
+            pp.query("verbose", p.verbose);
+            pp.query("ascalar_change", p.ascalar_change);
+        }
+
+        for (Real ascalar_change : {Real(0.), p.ascalar_change}) {
+            amrex::Print() << "Change of alpha between solves: " << ascalar_change << "\n";
+
+            Vector<MultiFab> sol_ref, sol_rec;
+
+            amrex::Print() << "Without recycling:\n";
+            int iters_ref = run_sequence(p, 0, ascalar_change, sol_ref);
+            amrex::Print() << "With recycling (recycle_size = " << p.recycle_size << "):\n";
+            int iters_rec = run_sequence(p, p.recycle_size, ascalar_change, sol_rec);
+
+            Real max_rel_diff = 0.;
+            for (int isolve = 0; isolve < p.nsolves; ++isolve) {
+                Real solnorm = sol_ref[isolve].norminf(0);
+                MultiFab::Subtract(sol_rec[isolve], sol_ref[isolve], 0, 0, 1, 0);
+                max_rel_diff = std::max(max_rel_diff, sol_rec[isolve].norminf(0) / solnorm);
+            }
+
+            amrex::Print() << "Cumulative GMRES iterations: " << iters_ref
+                           << " without recycling, " << iters_rec << " with recycling\n"
+                           << "Max relative difference in solutions: " << max_rel_diff << "\n";
+
+            AMREX_ALWAYS_ASSERT(max_rel_diff < Real(1.e-5));
+            if (p.recycle_size > 0 && p.nsolves > 1) {
+                AMREX_ALWAYS_ASSERT(iters_rec < iters_ref);
+            }
+        }
+    }
+    amrex::Finalize();
+}
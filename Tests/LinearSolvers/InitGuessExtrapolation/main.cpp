@@ -0,0 +1,181 @@
+//
+// Solves a sequence of problems with MLMG::setInitialGuessExtrapolation,
+// on one and on two AMR levels, and checks that the solutions of previous
+// solves are only used while the operator does not change.  Solving the
+// same problem again needs no iteration.  After new coefficients, or after
+// new scalars and MLMG::clearInitialGuessHistory, the solve must start from
+// the initial guess passed to it, like a solve with a new MLMG.
+//
+
+#include <AMReX.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+namespace {
+
+struct TestParams
+{
+    int n_cell = 32;
+    int max_grid_size = 16;
+    Real reltol = Real(1.e-10);
+    int verbose = 0;
+};
+
+struct Problem
+{
+    Vector<Geometry> geom;
+    Vector<BoxArray> grids;
+    Vector<DistributionMapping> dmap;
+    Vector<MultiFab> rhs;
+};
+
+Problem make_problem (TestParams const& p, int nlevels)
+{
+    Problem prob;
+    prob.geom.resize(nlevels);
+    prob.grids.resize(nlevels);
+    prob.dmap.resize(nlevels);
+    prob.rhs.resize(nlevels);
+
+    Box domain(IntVect(0), IntVect(p.n_cell-1));
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    for (int lev = 0; lev < nlevels; ++lev) {
+        prob.geom[lev].define(domain, rb, CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+        if (lev == 0) {
+            prob.grids[lev].define(domain);
+        } else {
+            // The middle of the domain
+            prob.grids[lev].define(amrex::grow(domain, -p.n_cell/4));
+        }
+        prob.grids[lev].maxSize(p.max_grid_size);
+        prob.dmap[lev].define(prob.grids[lev]);
+        domain.refine(2);
+
+        const auto problo = prob.geom[lev].ProbLoArray();
+        const auto dx = prob.geom[lev].CellSizeArray();
+        prob.rhs[lev].define(prob.grids[lev], prob.dmap[lev], 1, 0);
+        auto const& ma = prob.rhs[lev].arrays();
+        ParallelFor(prob.rhs[lev], [=] AMREX_GPU_DEVICE (int b, int i, int j, int k) noexcept
+        {
+            AMREX_D_TERM(Real x = problo[0] + (Real(i)+Real(0.5))*dx[0];,
+                         Real y = problo[1] + (Real(j)+Real(0.5))*dx[1];,
+                         Real z = problo[2] + (Real(k)+Real(0.5))*dx[2];);
+            ma[b](i,j,k) = AMREX_D_TERM(std::sin(Real(3.)*x), *std::cos(Real(2.)*y),
+                                        *(Real(1.)+z*z));
+        });
+    }
+    Gpu::streamSynchronize();
+    return prob;
+}
+
+void define_op (MLABecLaplacian& mlabec, Problem const& prob, Real alpha, Real acoef)
+{
+    mlabec.define(prob.geom, prob.grids, prob.dmap);
+    mlabec.setDomainBC({AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet)},
+                       {AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet)});
+    mlabec.setScalars(alpha, Real(1.));
+    for (int lev = 0; lev < int(prob.geom.size()); ++lev) {
+        mlabec.setLevelBC(lev, nullptr);
+        mlabec.setACoeffs(lev, acoef);
+        mlabec.setBCoeffs(lev, Real(1.));
+    }
+}
+
+// Solves from a zero initial guess and returns the number of iterations.
+int solve (MLMG& mlmg, TestParams const& p, Problem const& prob, Vector<MultiFab>& sol)
+{
+    const int nlevels = int(prob.geom.size());
+    sol.resize(nlevels);
+    for (int lev = 0; lev < nlevels; ++lev) {
+        sol[lev].define(prob.grids[lev], prob.dmap[lev], 1, 1);
+        sol[lev].setVal(Real(0.));
+    }
+    mlmg.solve(GetVecOfPtrs(sol), GetVecOfConstPtrs(prob.rhs), p.reltol, Real(0.));
+    return mlmg.getNumIters();
+}
+
+// Solves with a new operator and a new MLMG, and checks that the solution
+// and the number of iterations are the same.
+void check_fresh (TestParams const& p, Problem const& prob, Real alpha, Real acoef,
+                  int niters, Vector<MultiFab> const& sol, std::string const& what)
+{
+    MLABecLaplacian mlabec;
+    define_op(mlabec, prob, alpha, acoef);
+    MLMG mlmg(mlabec);
+    mlmg.setVerbose(p.verbose);
+    Vector<MultiFab> sol_fresh;
+    const int niters_fresh = solve(mlmg, p, prob, sol_fresh);
+
+    Real max_diff = 0;
+    for (int lev = 0; lev < int(sol.size()); ++lev) {
+        MultiFab::Subtract(sol_fresh[lev], sol[lev], 0, 0, 1, 0);
+        max_diff = std::max(max_diff, sol_fresh[lev].norminf(0, 0));
+    }
+    amrex::Print() << "  " << what << ": " << niters << " iterations, " << niters_fresh
+                   << " with a new MLMG, max difference " << max_diff << "\n";
+    AMREX_ALWAYS_ASSERT(niters == niters_fresh && niters > 0);
+    AMREX_ALWAYS_ASSERT(max_diff < Real(1.e-12));
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        TestParams p;
+        {
+            ParmParse pp;
+            pp.query("n_cell", p.n_cell);
+            pp.query("max_grid_size", p.max_grid_size);
+            pp.query("reltol", p.reltol);
+            pp.query("verbose", p.verbose);
+        }
+
+        for (int nlevels : {1, 2}) {
+            amrex::Print() << nlevels << " AMR level(s)\n";
+            const auto prob = make_problem(p, nlevels);
+
+            MLABecLaplacian mlabec;
+            define_op(mlabec, prob, Real(1.), Real(1.));
+            MLMG mlmg(mlabec);
+            mlmg.setVerbose(p.verbose);
+            mlmg.setInitialGuessExtrapolation(1);
+
+            Vector<MultiFab> sol;
+            int niters = solve(mlmg, p, prob, sol);
+            check_fresh(p, prob, Real(1.), Real(1.), niters, sol, "First solve");
+
+            // The previous solution is used, so nothing is left to do.
+            niters = solve(mlmg, p, prob, sol);
+            amrex::Print() << "  Same problem again: " << niters << " iterations\n";
+            AMREX_ALWAYS_ASSERT(niters == 0);
+
+            // New coefficients: the previous solution must not be used.  The
+            // change is small, so that it would be a good initial guess and
+            // save iterations.
+            for (int lev = 0; lev < nlevels; ++lev) {
+                mlabec.setACoeffs(lev, Real(1.01));
+            }
+            niters = solve(mlmg, p, prob, sol);
+            check_fresh(p, prob, Real(1.), Real(1.01), niters, sol, "New coefficients");
+
+            // New scalars are not seen by MLMG, so the history is cleared
+            // explicitly.
+            mlabec.setScalars(Real(1.01), Real(1.));
+            mlmg.clearInitialGuessHistory();
+            niters = solve(mlmg, p, prob, sol);
+            check_fresh(p, prob, Real(1.01), Real(1.01), niters, sol, "New scalars");
+        }
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,117 @@
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Particles.H>
+#include <AMReX_ParticleMesh.H>
+#include <AMReX_ParticleInterpolators.H>
+
+using namespace amrex;
+
+using PC = ParticleContainer<1>;
+
+template <int order>
+void benchmark (PC const& pc, MultiFab& rho_atomic, MultiFab& rho_colored, int nreps)
+{
+    const auto plo = pc.Geom(0).ProbLoArray();
+    const auto dxi = pc.Geom(0).InvCellSizeArray();
+
+    auto deposit = [=] AMREX_GPU_DEVICE (const PC::ParticleType& p,
+                                         amrex::Array4<amrex::Real> const& rho)
+    {
+        ParticleInterpolator::Shape<order> interp(p, plo, dxi);
+        interp.ParticleToMesh(p, rho, 0, 0, 1,
+            [=] AMREX_GPU_DEVICE (const PC::ParticleType& part, int comp)
+            {
+                return part.rdata(comp);
+            });
+    };
+
+    // warm up both paths once
+    ParticleToMesh(pc, rho_atomic, 0, deposit);
+    ParticleToMeshColored(pc, rho_colored, 0, deposit);
+
+    Real t_atomic = 0.0;
+    Real t_colored = 0.0;
+    for (int irep = 0; irep < nreps; ++irep) {
+        ParallelDescriptor::Barrier();
+        auto t0 = amrex::second();
+        ParticleToMesh(pc, rho_atomic, 0, deposit);
+        auto t1 = amrex::second();
+        ParticleToMeshColored(pc, rho_colored, 0, deposit);
+        auto t2 = amrex::second();
+        t_atomic += t1 - t0;
+        t_colored += t2 - t1;
+    }
+    ParallelDescriptor::ReduceRealMax(t_atomic);
+    ParallelDescriptor::ReduceRealMax(t_colored);
+
+    amrex::Print() << "ParticleToMesh (atomic merge)  : " << t_atomic/nreps << " s per call\n"
+                   << "ParticleToMeshColored          : " << t_colored/nreps << " s per call\n";
+}
+
+void run ()
+{
+    ParmParse pp("bench");
+
+    int n_cell = 64;
+    pp.query("n_cell", n_cell);
+    int max_grid_size = 32;
+    pp.query("max_grid_size", max_grid_size);
+    int nppc = 8;
+    pp.query("nppc", nppc);
+    int order = 2;
+    pp.query("order", order);
+    int nreps = 5;
+    pp.query("nreps", nreps);
+    bool sort = true;
+    pp.query("sort", sort);
+
+    AMREX_ALWAYS_ASSERT(order >= 0 && order <= 3);
+
+    Box domain(IntVect(0), IntVect(n_cell-1));
+    RealBox real_box({AMREX_D_DECL(0.0,0.0,0.0)}, {AMREX_D_DECL(1.0,1.0,1.0)});
+    Array<int,AMREX_SPACEDIM> is_per{AMREX_D_DECL(1,1,1)};
+    Geometry geom(domain, real_box, CoordSys::cartesian, is_per);
+
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    PC pc(geom, dm, ba);
+    PC::ParticleInitData pdata = {{1.0}, {}, {}, {}};
+    pc.InitRandom(Long(nppc)*domain.numPts(), 451, pdata, false);
+    if (sort) { pc.SortParticlesByMortonKey(); }
+
+    // Just the ghost cells the stencil reaches, which the colored path
+    // grows its buffers by.
+    const int ng = (order+1)/2;
+    MultiFab rho_atomic(ba, dm, 1, ng);
+    MultiFab rho_colored(ba, dm, 1, ng);
+
+    amrex::Print() << "Depositing " << pc.TotalNumberOfParticles() << " particles on "
+                   << ba.size() << " grids with order " << order
+                   << (sort ? ", sorted\n" : ", unsorted\n");
+
+    switch (order) {
+    case 0: benchmark<0>(pc, rho_atomic, rho_colored, nreps); break;
+    case 1: benchmark<1>(pc, rho_atomic, rho_colored, nreps); break;
+    case 2: benchmark<2>(pc, rho_atomic, rho_colored, nreps); break;
+    default: benchmark<3>(pc, rho_atomic, rho_colored, nreps); break;
+    }
+
+    // Both paths must give the same answer up to roundoff, and all the
+    // mass must have been deposited.
+    const Real total = rho_atomic.sum(0);
+    MultiFab::Subtract(rho_colored, rho_atomic, 0, 0, 1, 0);
+    const Real err = rho_colored.norminf(0);
+    amrex::Print() << "Total mass " << total << ", max difference " << err << "\n";
+    AMREX_ALWAYS_ASSERT(err <= Real(1.e-10) * total / Real(domain.numPts()));
+    AMREX_ALWAYS_ASSERT(std::abs(total - Real(pc.TotalNumberOfParticles())) <= Real(1.e-8) * total);
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    run();
+    amrex::Finalize();
+}
@@ -0,0 +1,254 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Particles.H>
+#include <AMReX_NeighborParticles.H>
+
+#include <algorithm>
+#include <random>
+
+using namespace amrex;
+
+// Two array components: the first one is communicated by the halo fill,
+// the second one is masked out.
+using PC = NeighborParticleContainer<0, 0, 2, 0>;
+using PType = PC::ParticleType;
+
+struct TestParams
+{
+    int size;
+    int max_grid_size;
+    int num_ppc;
+    int num_neighbor_cells;
+};
+
+void get_test_params (TestParams& params, const std::string& prefix)
+{
+    ParmParse pp(prefix);
+    pp.get("size", params.size);
+    pp.get("max_grid_size", params.max_grid_size);
+    pp.get("num_ppc", params.num_ppc);
+    pp.get("num_neighbor_cells", params.num_neighbor_cells);
+}
+
+struct NeighborRecord
+{
+    int grid;
+    int cpu;
+    Long id;
+    RealVect pos;
+    Real value;
+};
+
+bool operator< (NeighborRecord const& a, NeighborRecord const& b)
+{
+    return std::tie(a.grid, a.cpu, a.id, a.pos[0]) < std::tie(b.grid, b.cpu, b.id, b.pos[0]);
+}
+
+// The neighbors [begin,end) of ptile, seen from grid.
+template <class PTile>
+void append_records (Vector<NeighborRecord>& records, PTile const& ptile, int grid,
+                     int begin, int end)
+{
+    const int n = end - begin;
+    if (n <= 0) { return; }
+    constexpr int stride = AMREX_SPACEDIM + 3;
+    Gpu::DeviceVector<ParticleReal> d_buf(std::size_t(n)*stride);
+    auto* pbuf = d_buf.dataPtr();
+    auto ptd = ptile.getConstParticleTileData();
+    amrex::ParallelFor(n, [=] AMREX_GPU_DEVICE (int i) noexcept
+    {
+        ParticleReal* b = pbuf + std::size_t(i)*stride;
+        for (int d = 0; d < AMREX_SPACEDIM; ++d) { b[d] = ptd.pos(d, begin+i); }
+        b[AMREX_SPACEDIM] = ParticleReal(ptd.id(begin+i));
+        b[AMREX_SPACEDIM+1] = ParticleReal(ptd.cpu(begin+i));
+        b[AMREX_SPACEDIM+2] = ptd.m_rdata[0][begin+i];
+    });
+    Gpu::HostVector<ParticleReal> h_buf(d_buf.size());
+    Gpu::copyAsync(Gpu::deviceToHost, d_buf.begin(), d_buf.end(), h_buf.begin());
+    Gpu::streamSynchronize();
+    for (int i = 0; i < n; ++i) {
+        ParticleReal const* b = h_buf.data() + std::size_t(i)*stride;
+        NeighborRecord r;
+        r.grid = grid;
+        for (int d = 0; d < AMREX_SPACEDIM; ++d) { r.pos[d] = b[d]; }
+        r.id = Long(b[AMREX_SPACEDIM]);
+        r.cpu = int(b[AMREX_SPACEDIM+1]);
+        r.value = b[AMREX_SPACEDIM+2];
+        records.push_back(r);
+    }
+}
+
+// The neighbors are stored after the particles of the tile, except by the
+// full exchange on the CPU, which keeps them in separate tiles.
+Vector<NeighborRecord> get_neighbors (PC& pc, bool separate_tiles)
+{
+    Vector<NeighborRecord> records;
+    for (MFIter mfi = pc.MakeMFIter(0); mfi.isValid(); ++mfi) {
+        auto& ptile = pc.DefineAndReturnParticleTile(0, mfi);
+        if (separate_tiles) {
+            auto const& ntile = pc.GetNeighbors(0, mfi.index(), mfi.LocalTileIndex());
+            append_records(records, ntile, mfi.index(), 0, int(ntile.numParticles()));
+        } else {
+            const int np = int(ptile.numParticles());
+            append_records(records, ptile, mfi.index(), np, np + ptile.getNumNeighbors());
+        }
+    }
+    std::sort(records.begin(), records.end());
+    return records;
+}
+
+void check_same (Vector<NeighborRecord> const& a, Vector<NeighborRecord> const& b)
+{
+    AMREX_ALWAYS_ASSERT(a.size() == b.size());
+    for (int i = 0; i < a.size(); ++i) {
+        AMREX_ALWAYS_ASSERT(a[i].grid == b[i].grid && a[i].cpu == b[i].cpu && a[i].id == b[i].id);
+        for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+            AMREX_ALWAYS_ASSERT(std::abs(a[i].pos[d] - b[i].pos[d]) < Real(1.e-10));
+        }
+        AMREX_ALWAYS_ASSERT(a[i].value == b[i].value);
+    }
+}
+
+void init_particles (PC& pc, int num_ppc)
+{
+    const auto& geom = pc.Geom(0);
+    const auto plo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    std::mt19937 gen(1234 + ParallelDescriptor::MyProc());
+    std::uniform_real_distribution<Real> uniform(Real(0.), Real(1.));
+    // Both containers get the same particles, ids included.
+    Long next_id = 1;
+    for (MFIter mfi = pc.MakeMFIter(0); mfi.isValid(); ++mfi) {
+        const Box& bx = mfi.validbox();
+        const int np = int(bx.numPts()) * num_ppc;
+        PC::ParticleTileType::AoS::ParticleVector host_particles;
+        std::array<Gpu::HostVector<ParticleReal>,2> host_reals;
+        for (int i = 0; i < np; ++i) {
+            PType p;
+            p.id() = next_id++;
+            p.cpu() = ParallelDescriptor::MyProc();
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                p.pos(d) = plo[d] + (bx.smallEnd(d) + uniform(gen)*bx.length(d))*dx[d];
+            }
+            host_particles.push_back(p);
+            host_reals[0].push_back(ParticleReal(p.id()));
+            host_reals[1].push_back(ParticleReal(-1.));
+        }
+        auto& ptile = pc.DefineAndReturnParticleTile(0, mfi);
+        ptile.resize(np);
+        Gpu::copyAsync(Gpu::hostToDevice, host_particles.begin(), host_particles.end(),
+                       ptile.GetArrayOfStructs().begin());
+        for (int comp = 0; comp < 2; ++comp) {
+            Gpu::copyAsync(Gpu::hostToDevice, host_reals[comp].begin(), host_reals[comp].end(),
+                           ptile.GetStructOfArrays().GetRealData(comp).begin());
+        }
+    }
+    Gpu::streamSynchronize();
+}
+
+// Moves the particles by a fraction of a cell towards the center of their
+// grid, so that they stay in it, and changes the first component.
+void move_particles (PC& pc)
+{
+    const auto& geom = pc.Geom(0);
+    const auto plo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    for (MFIter mfi = pc.MakeMFIter(0); mfi.isValid(); ++mfi) {
+        const Box& bx = mfi.validbox();
+        RealVect center;
+        for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+            center[d] = plo[d] + Real(0.5)*(bx.smallEnd(d)+bx.bigEnd(d)+1)*dx[d];
+        }
+        auto& ptile = pc.DefineAndReturnParticleTile(0, mfi);
+        auto ptd = ptile.getParticleTileData();
+        amrex::ParallelFor(ptile.numParticles(), [=] AMREX_GPU_DEVICE (int i) noexcept
+        {
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                ptd.pos(d, i) += ParticleReal(0.1)*(center[d] - ptd.pos(d, i));
+            }
+            ptd.m_rdata[0][i] += ParticleReal(1.);
+        });
+    }
+    Gpu::streamSynchronize();
+}
+
+void testHaloNeighbors (TestParams const& params)
+{
+    RealBox real_box;
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+        real_box.setLo(d, 0.0);
+        real_box.setHi(d, 1.0);
+    }
+    const Box domain(IntVect(0), IntVect(params.size - 1));
+    Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(1,1,0)};
+    Geometry geom(domain, real_box, CoordSys::cartesian, is_periodic);
+
+    BoxArray ba(domain);
+    ba.maxSize(params.max_grid_size);
+    DistributionMapping dm(ba);
+
+    const int ncells = params.num_neighbor_cells;
+    PC pc_full(geom, dm, ba, ncells);
+    PC pc_halo(geom, dm, ba, ncells);
+    init_particles(pc_full, params.num_ppc);
+    init_particles(pc_halo, params.num_ppc);
+
+#ifdef AMREX_USE_GPU
+    const bool separate_tiles = false;
+#else
+    const bool separate_tiles = true;
+#endif
+
+    // Only the first array component is communicated by the halo fill.
+    Vector<int> real_mask(AMREX_SPACEDIM + 2, 1);
+    real_mask[AMREX_SPACEDIM+1] = 0;
+
+    // With the same width, the halo fill finds the same neighbors as the
+    // full exchange.
+    pc_full.fillNeighbors();
+    pc_halo.fillNeighbors(IntVect(ncells), real_mask);
+    auto full = get_neighbors(pc_full, separate_tiles);
+    AMREX_ALWAYS_ASSERT(! full.empty());
+    check_same(full, get_neighbors(pc_halo, false));
+    amrex::Print() << "fillNeighbors with a halo passed\n";
+
+    // updateNeighbors sends the new data of the same particles.
+    for (int step = 0; step < 2; ++step) {
+        move_particles(pc_full);
+        move_particles(pc_halo);
+        pc_full.updateNeighbors();
+        pc_halo.updateNeighbors();
+        full = get_neighbors(pc_full, separate_tiles);
+        check_same(full, get_neighbors(pc_halo, false));
+    }
+    amrex::Print() << "updateNeighbors with a halo passed\n";
+
+    // A narrower halo finds the neighbors of the full exchange within it.
+    const IntVect halo(ncells-1);
+    pc_halo.fillNeighbors(halo, real_mask);
+    Vector<NeighborRecord> expected;
+    const auto plo = geom.ProbLoArray();
+    const auto dxi = geom.InvCellSizeArray();
+    for (auto const& r : full) {
+        IntVect cell;
+        for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+            cell[d] = static_cast<int>(std::floor((r.pos[d]-plo[d])*dxi[d]));
+        }
+        if (amrex::grow(ba[r.grid], halo).contains(cell)) { expected.push_back(r); }
+    }
+    AMREX_ALWAYS_ASSERT(expected.size() < full.size());
+    check_same(expected, get_neighbors(pc_halo, false));
+    amrex::Print() << "fillNeighbors with a narrower halo passed\n";
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        TestParams params;
+        get_test_params(params, "halo");
+
+        testHaloNeighbors(params);
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,226 @@
+//
+// Checks SortParticlesByMortonKey: after the sort, the Morton keys of the
+// particles of every tile are in increasing order, particles with the same
+// key keep their relative order, and the particle data move with the
+// particles.  The particles are sorted after they are created, and again
+// after a Redistribute has appended the particles that changed grid.  A long
+// grid, whose keys are built on a coarsened curve, is also checked.
+//
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Particles.H>
+
+#include <random>
+
+using namespace amrex;
+
+// The Real component holds a function of the id, the Int component the
+// index of the particle in its tile before the sort.
+using PC = ParticleContainer<0, 0, 1, 1>;
+using PType = PC::ParticleType;
+
+struct TestParams
+{
+    int size;
+    int max_grid_size;
+    int num_ppc;
+};
+
+void get_test_params (TestParams& params, const std::string& prefix)
+{
+    ParmParse pp(prefix);
+    pp.get("size", params.size);
+    pp.get("max_grid_size", params.max_grid_size);
+    pp.get("num_ppc", params.num_ppc);
+}
+
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+ParticleReal id_value (Long id) noexcept
+{
+    return ParticleReal(0.5)*ParticleReal(id);
+}
+
+void init_particles (PC& pc, int num_ppc)
+{
+    const auto& geom = pc.Geom(0);
+    const auto plo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    std::mt19937 gen(1234 + ParallelDescriptor::MyProc());
+    std::uniform_real_distribution<Real> uniform(Real(0.), Real(1.));
+    for (MFIter mfi = pc.MakeMFIter(0); mfi.isValid(); ++mfi) {
+        const Box& bx = mfi.validbox();
+        const int np = int(bx.numPts()) * num_ppc;
+        PC::ParticleTileType::AoS::ParticleVector host_particles;
+        Gpu::HostVector<ParticleReal> host_reals;
+        for (int i = 0; i < np; ++i) {
+            PType p;
+            p.id() = PType::NextID();
+            p.cpu() = ParallelDescriptor::MyProc();
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                p.pos(d) = plo[d] + (bx.smallEnd(d) + uniform(gen)*bx.length(d))*dx[d];
+            }
+            host_particles.push_back(p);
+            host_reals.push_back(id_value(p.id()));
+        }
+        auto& ptile = pc.DefineAndReturnParticleTile(0, mfi);
+        ptile.resize(np);
+        Gpu::copyAsync(Gpu::hostToDevice, host_particles.begin(), host_particles.end(),
+                       ptile.GetArrayOfStructs().begin());
+        Gpu::copyAsync(Gpu::hostToDevice, host_reals.begin(), host_reals.end(),
+                       ptile.GetStructOfArrays().GetRealData(0).begin());
+    }
+    Gpu::streamSynchronize();
+}
+
+// Stores the index of every particle in its tile.
+void number_particles (PC& pc)
+{
+    for (MFIter mfi = pc.MakeMFIter(0); mfi.isValid(); ++mfi) {
+        auto& ptile = pc.DefineAndReturnParticleTile(0, mfi);
+        auto* p = ptile.GetStructOfArrays().GetIntData(0).dataPtr();
+        amrex::ParallelFor(ptile.numParticles(), [=] AMREX_GPU_DEVICE (int i) noexcept
+        {
+            p[i] = i;
+        });
+    }
+    Gpu::streamSynchronize();
+}
+
+// Moves the particles by a fraction of the domain in the first direction,
+// which is periodic, so that many of them change grid.
+void move_particles (PC& pc, Real fraction)
+{
+    const auto& geom = pc.Geom(0);
+    const Real plo = geom.ProbLo(0);
+    const Real len = geom.ProbLength(0);
+    for (MFIter mfi = pc.MakeMFIter(0); mfi.isValid(); ++mfi) {
+        auto& ptile = pc.DefineAndReturnParticleTile(0, mfi);
+        auto ptd = ptile.getParticleTileData();
+        amrex::ParallelFor(ptile.numParticles(), [=] AMREX_GPU_DEVICE (int i) noexcept
+        {
+            ParticleReal x = ptd.pos(0, i) + ParticleReal(fraction*len);
+            if (x >= plo + len) { x -= len; }
+            ptd.pos(0, i) = x;
+        });
+    }
+    Gpu::streamSynchronize();
+}
+
+struct SortCheck
+{
+    Long num_particles = 0;
+    Long num_descents = 0;  // consecutive particles with decreasing keys
+    Long num_unstable = 0;  // consecutive particles with the same key in the wrong order
+    Long num_wrong = 0;     // particles whose data do not match their id
+};
+
+SortCheck check_sorted (PC& pc)
+{
+    const auto& geom = pc.Geom(0);
+    SortCheck r;
+    for (MFIter mfi = pc.MakeMFIter(0); mfi.isValid(); ++mfi) {
+        auto& ptile = pc.DefineAndReturnParticleTile(0, mfi);
+        const int np = int(ptile.numParticles());
+        r.num_particles += np;
+        if (np == 0) { continue; }
+
+        const Box& box = mfi.validbox();
+        const GetParticleMortonKey get_key{geom.ProbLoArray(), geom.InvCellSizeArray(),
+                                           geom.Domain(), box,
+                                           GetParticleMortonKey::mortonShift(box)};
+        Gpu::DeviceVector<std::uint32_t> keys(np);
+        auto* pkeys = keys.dataPtr();
+        const auto ptd = ptile.getConstParticleTileData();
+        auto const* pr = ptile.GetStructOfArrays().GetRealData(0).dataPtr();
+        auto const* pi = ptile.GetStructOfArrays().GetIntData(0).dataPtr();
+        amrex::ParallelFor(np, [=] AMREX_GPU_DEVICE (int i) noexcept
+        {
+            pkeys[i] = get_key(ptd, i);
+        });
+
+        ReduceOps<ReduceOpSum, ReduceOpSum, ReduceOpSum> reduce_op;
+        ReduceData<Long, Long, Long> reduce_data(reduce_op);
+        reduce_op.eval(np, reduce_data,
+        [=] AMREX_GPU_DEVICE (int i) -> GpuTuple<Long, Long, Long>
+        {
+            Long descent = 0;
+            Long unstable = 0;
+            if (i+1 < np) {
+                descent = Long(pkeys[i+1] < pkeys[i]);
+                unstable = Long(pkeys[i+1] == pkeys[i] && pi[i+1] < pi[i]);
+            }
+            return {descent, unstable, Long(pr[i] != id_value(ptd.id(i)))};
+        });
+        auto hv = reduce_data.value(reduce_op);
+        r.num_descents += amrex::get<0>(hv);
+        r.num_unstable += amrex::get<1>(hv);
+        r.num_wrong += amrex::get<2>(hv);
+    }
+    ParallelDescriptor::ReduceLongSum(r.num_particles);
+    ParallelDescriptor::ReduceLongSum(r.num_descents);
+    ParallelDescriptor::ReduceLongSum(r.num_unstable);
+    ParallelDescriptor::ReduceLongSum(r.num_wrong);
+    return r;
+}
+
+// Sorts the particles and checks the result.
+void sort_and_check (PC& pc, Long np, std::string const& what)
+{
+    number_particles(pc);
+    const Long num_descents_before = check_sorted(pc).num_descents;
+    pc.SortParticlesByMortonKey();
+    const auto r = check_sorted(pc);
+    amrex::Print() << what << ": " << num_descents_before << " descents before the sort, "
+                   << r.num_descents << " after, " << r.num_unstable << " unstable, "
+                   << r.num_wrong << " wrong values, " << r.num_particles << " of " << np
+                   << " particles\n";
+    AMREX_ALWAYS_ASSERT(num_descents_before > 0);
+    AMREX_ALWAYS_ASSERT(r.num_descents == 0 && r.num_unstable == 0 && r.num_wrong == 0);
+    AMREX_ALWAYS_ASSERT(r.num_particles == np);
+}
+
+void testMortonSort (TestParams const& params, Box const& domain, int max_grid_size,
+                     std::string const& what)
+{
+    RealBox real_box;
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+        real_box.setLo(d, 0.0);
+        real_box.setHi(d, 1.0);
+    }
+    Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(1,1,1)};
+    Geometry geom(domain, real_box, CoordSys::cartesian, is_periodic);
+
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    PC pc(geom, dm, ba);
+    init_particles(pc, params.num_ppc);
+    const Long np = pc.TotalNumberOfParticles();
+    sort_and_check(pc, np, what + ", new particles");
+
+    move_particles(pc, Real(0.3));
+    pc.Redistribute();
+    sort_and_check(pc, np, what + ", after Redistribute");
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        TestParams params;
+        get_test_params(params, "sort");
+
+        testMortonSort(params, Box(IntVect(0), IntVect(params.size-1)), params.max_grid_size,
+                       "Grids of size " + std::to_string(params.max_grid_size));
+
+        // A single grid that is too long, in 3D, for the 10 bits per
+        // direction of the keys, so the curve is coarsened in the first
+        // direction.
+        IntVect big(4);
+        big[0] = 2048;
+        testMortonSort(params, Box(IntVect(0), big-1), 2048, "Long grid");
+    }
+    amrex::Finalize();
+}
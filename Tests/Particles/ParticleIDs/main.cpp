@@ -0,0 +1,193 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Particles.H>
+
+#include <algorithm>
+
+using namespace amrex;
+
+using PC = ParticleContainer<0, 0>;
+using PType = PC::ParticleType;
+
+struct TestParams
+{
+    IntVect size;
+    int max_grid_size;
+    int num_ppc;
+    Long block_size;
+};
+
+void get_test_params (TestParams& params, const std::string& prefix)
+{
+    ParmParse pp(prefix);
+    pp.get("size", params.size);
+    pp.get("max_grid_size", params.max_grid_size);
+    pp.get("num_ppc", params.num_ppc);
+    pp.get("block_size", params.block_size);
+}
+
+// All the IDs must be distinct and valid.
+void checkUnique (Vector<Long>& ids)
+{
+    std::sort(ids.begin(), ids.end());
+    AMREX_ALWAYS_ASSERT(std::adjacent_find(ids.begin(), ids.end()) == ids.end());
+    AMREX_ALWAYS_ASSERT(ids.empty() || (ids.front() > 0 &&
+                                        ids.back() <= LongParticleIds::LastParticleID));
+}
+
+void testNextIDs ()
+{
+    const Long first = PType::NextIDs(10);
+    AMREX_ALWAYS_ASSERT(PType::NextID() == first + 10);
+    AMREX_ALWAYS_ASSERT(PType::NextIDs(0) == first + 11);
+
+    auto range = reserveParticleIDs<PType>(5);
+    AMREX_ALWAYS_ASSERT(range.first == first + 11 && range.count == 5 &&
+                        range.cpu == ParallelDescriptor::MyProc());
+    AMREX_ALWAYS_ASSERT(range.id(4) == first + 15);
+
+    // Blocks reserved by several threads must not overlap.
+    const int nblocks = 64;
+    const Long n = 13;
+    Vector<Long> ids(nblocks*n);
+#ifdef AMREX_USE_OMP
+#pragma omp parallel for
+#endif
+    for (int ib = 0; ib < nblocks; ++ib) {
+        const Long id0 = PType::NextIDs(n);
+        for (Long i = 0; i < n; ++i) {
+            ids[ib*n+i] = id0 + i;
+        }
+    }
+    checkUnique(ids);
+    AMREX_ALWAYS_ASSERT(PType::NextID() == first + 16 + nblocks*n);
+
+    amrex::Print() << "NextIDs passed\n";
+}
+
+void testAllocator (Long block_size)
+{
+    const int nids = 1000;
+    Vector<Long> ids(nids);
+    {
+        ParticleIDAllocator<PType> id_alloc(block_size);
+        AMREX_ALWAYS_ASSERT(id_alloc.blockSize() == block_size &&
+                            id_alloc.cpu() == ParallelDescriptor::MyProc());
+#ifdef AMREX_USE_OMP
+#pragma omp parallel for
+#endif
+        for (int i = 0; i < nids; ++i) {
+            ids[i] = id_alloc.next();
+        }
+    }
+    checkUnique(ids);
+    // The allocator hands out IDs in whole blocks only.
+    AMREX_ALWAYS_ASSERT(PType::NextID() > ids.back());
+
+    amrex::Print() << "ParticleIDAllocator passed\n";
+}
+
+void testRenumber (TestParams const& params)
+{
+    RealBox real_box;
+    for (int n = 0; n < AMREX_SPACEDIM; n++) {
+        real_box.setLo(n, 0.0);
+        real_box.setHi(n, params.size[n]);
+    }
+    const Box domain(IntVect(0), params.size - 1);
+    Array<int,AMREX_SPACEDIM> is_per{AMREX_D_DECL(1,1,1)};
+    Geometry geom(domain, real_box, CoordSys::cartesian, is_per);
+    BoxArray ba(domain);
+    ba.maxSize(params.max_grid_size);
+    DistributionMapping dm(ba);
+
+    PC pc(geom, dm, ba);
+
+    // Particles get their IDs from blocks reserved inside the kernels.
+    // Some of them are then invalidated or flagged with the split IDs.
+    const int lev = 0;
+    const auto dx = geom.CellSizeArray();
+    const auto plo = geom.ProbLoArray();
+    const int num_ppc = params.num_ppc;
+    Long num_valid = 0;
+    for (MFIter mfi = pc.MakeMFIter(lev); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        const int np = static_cast<int>(bx.numPts()) * num_ppc;
+        auto& ptile = pc.DefineAndReturnParticleTile(lev, mfi);
+        ptile.resize(np);
+        auto ptd = ptile.getParticleTileData();
+        auto ids = reserveParticleIDs<PType>(np);
+        const auto lo = amrex::lbound(bx);
+        const auto len = amrex::length(bx);
+        amrex::ParallelFor(np, [=] AMREX_GPU_DEVICE (int i) noexcept
+        {
+            const int icell = i / num_ppc;
+            const int ii = lo.x + icell % len.x;
+            const int jj = lo.y + (icell / len.x) % len.y;
+            const int kk = lo.z + icell / (len.x*len.y);
+            ptd.id(i) = ids.id(i);
+            ptd.cpu(i) = ids.cpu;
+            AMREX_D_TERM(ptd.pos(0,i) = plo[0] + (ii+0.5_rt)*dx[0];,
+                         ptd.pos(1,i) = plo[1] + (jj+0.5_rt)*dx[1];,
+                         ptd.pos(2,i) = plo[2] + (kk+0.5_rt)*dx[2];)
+            if (i % 5 == 1) {
+                ptd.id(i) = -1;
+            } else if (i % 7 == 2) {
+                ptd.id(i) = LongParticleIds::DoSplitParticleID;
+            } else if (i % 11 == 3) {
+                ptd.id(i) = LongParticleIds::NoSplitParticleID;
+            }
+        });
+        for (int i = 0; i < np; ++i) {
+            if (i % 5 != 1 && i % 7 != 2 && i % 11 != 3) { ++num_valid; }
+        }
+    }
+    Gpu::streamSynchronize();
+
+    pc.RenumberParticleIDs();
+
+    Vector<Long> ids;
+    const int cpu = ParallelDescriptor::MyProc();
+    for (MFIter mfi = pc.MakeMFIter(lev); mfi.isValid(); ++mfi)
+    {
+        auto& ptile = pc.ParticlesAt(lev, mfi);
+        const int np = static_cast<int>(ptile.numParticles());
+        auto ptd = ptile.getParticleTileData();
+        for (int i = 0; i < np; ++i) {
+            const Long id = ptd.id(i);
+            if (i % 5 == 1) {
+                AMREX_ALWAYS_ASSERT(id == -1);
+            } else if (i % 7 == 2) {
+                AMREX_ALWAYS_ASSERT(id == LongParticleIds::DoSplitParticleID);
+            } else if (i % 11 == 3) {
+                AMREX_ALWAYS_ASSERT(id == LongParticleIds::NoSplitParticleID);
+            } else {
+                AMREX_ALWAYS_ASSERT(ptd.cpu(i) == cpu);
+                ids.push_back(id);
+            }
+        }
+    }
+
+    // The valid particles have the IDs 1 to num_valid.
+    AMREX_ALWAYS_ASSERT(Long(ids.size()) == num_valid);
+    checkUnique(ids);
+    AMREX_ALWAYS_ASSERT(ids.empty() || ids.back() == num_valid);
+    AMREX_ALWAYS_ASSERT(PType::NextID() == num_valid + 1);
+
+    amrex::Print() << "RenumberParticleIDs passed\n";
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        TestParams params;
+        get_test_params(params, "ids");
+
+        testNextIDs();
+        testAllocator(params.block_size);
+        testRenumber(params);
+    }
+    amrex::Finalize();
+}
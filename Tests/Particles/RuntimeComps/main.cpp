@@ -0,0 +1,280 @@
+//
+// Adds runtime components to a particle container, removes some of them,
+// and checks that the components after a removed one move down with their
+// data, through Redistribute and a checkpoint.  Transient components are
+// added for scratch data: they must not be written to the checkpoint, which
+// is restarted into a container without them, and they are removed at the end.
+//
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Particles.H>
+
+#include <random>
+
+using namespace amrex;
+
+static constexpr int NAR = 2;
+static constexpr int NAI = 1;
+
+using PC = ParticleContainer<0, 0, NAR, NAI>;
+using PType = PC::ParticleType;
+
+struct TestParams
+{
+    int size;
+    int max_grid_size;
+    int num_ppc;
+};
+
+void get_test_params (TestParams& params, const std::string& prefix)
+{
+    ParmParse pp(prefix);
+    pp.get("size", params.size);
+    pp.get("max_grid_size", params.max_grid_size);
+    pp.get("num_ppc", params.num_ppc);
+}
+
+// Every component holds a value made of the particle id and a tag, which
+// identifies the component whatever its current index.
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+ParticleReal real_value (Long id, int tag) noexcept
+{
+    return ParticleReal(id) + ParticleReal(0.125)*ParticleReal(tag);
+}
+
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+int int_value (Long id, int tag) noexcept
+{
+    return int(10*id) + tag;
+}
+
+// The tags of the components, by SoA index.  A negative tag is a
+// component that is not checked.
+struct CompTags
+{
+    Vector<int> real;
+    Vector<int> integer;
+};
+
+void init_particles (PC& pc, int num_ppc, CompTags const& tags)
+{
+    const auto& geom = pc.Geom(0);
+    const auto plo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    std::mt19937 gen(1234 + ParallelDescriptor::MyProc());
+    std::uniform_real_distribution<Real> uniform(Real(0.), Real(1.));
+    for (MFIter mfi = pc.MakeMFIter(0); mfi.isValid(); ++mfi) {
+        const Box& bx = mfi.validbox();
+        const int np = int(bx.numPts()) * num_ppc;
+        PC::ParticleTileType::AoS::ParticleVector host_particles;
+        Vector<Gpu::HostVector<ParticleReal>> host_reals(tags.real.size());
+        Vector<Gpu::HostVector<int>> host_ints(tags.integer.size());
+        for (int i = 0; i < np; ++i) {
+            PType p;
+            p.id() = PType::NextID();
+            p.cpu() = ParallelDescriptor::MyProc();
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                p.pos(d) = plo[d] + (bx.smallEnd(d) + uniform(gen)*bx.length(d))*dx[d];
+            }
+            host_particles.push_back(p);
+            for (int comp = 0; comp < tags.real.size(); ++comp) {
+                host_reals[comp].push_back(real_value(p.id(), tags.real[comp]));
+            }
+            for (int comp = 0; comp < tags.integer.size(); ++comp) {
+                host_ints[comp].push_back(int_value(p.id(), tags.integer[comp]));
+            }
+        }
+        auto& ptile = pc.DefineAndReturnParticleTile(0, mfi);
+        ptile.resize(np);
+        Gpu::copyAsync(Gpu::hostToDevice, host_particles.begin(), host_particles.end(),
+                       ptile.GetArrayOfStructs().begin());
+        auto& soa = ptile.GetStructOfArrays();
+        for (int comp = 0; comp < tags.real.size(); ++comp) {
+            Gpu::copyAsync(Gpu::hostToDevice, host_reals[comp].begin(), host_reals[comp].end(),
+                           soa.GetRealData(comp).begin());
+        }
+        for (int comp = 0; comp < tags.integer.size(); ++comp) {
+            Gpu::copyAsync(Gpu::hostToDevice, host_ints[comp].begin(), host_ints[comp].end(),
+                           soa.GetIntData(comp).begin());
+        }
+    }
+    Gpu::streamSynchronize();
+}
+
+// Sets the transient components of every particle.
+void fill_transient (PC& pc, int rcomp, int icomp, int rtag, int itag)
+{
+    for (MFIter mfi = pc.MakeMFIter(0); mfi.isValid(); ++mfi) {
+        auto& ptile = pc.DefineAndReturnParticleTile(0, mfi);
+        auto ptd = ptile.getParticleTileData();
+        auto* rp = ptile.GetStructOfArrays().GetRealData(rcomp).dataPtr();
+        auto* ip = ptile.GetStructOfArrays().GetIntData(icomp).dataPtr();
+        amrex::ParallelFor(ptile.numParticles(), [=] AMREX_GPU_DEVICE (int i) noexcept
+        {
+            rp[i] = real_value(ptd.id(i), rtag);
+            ip[i] = int_value(ptd.id(i), itag);
+        });
+    }
+    Gpu::streamSynchronize();
+}
+
+// Number of values that do not match their tag
+Long count_wrong (PC& pc, CompTags const& tags)
+{
+    AMREX_ALWAYS_ASSERT(pc.NumRealComps() == tags.real.size() &&
+                        pc.NumIntComps() == tags.integer.size());
+    ReduceOps<ReduceOpSum> reduce_op;
+    ReduceData<Long> reduce_data(reduce_op);
+    for (MFIter mfi = pc.MakeMFIter(0); mfi.isValid(); ++mfi) {
+        auto& ptile = pc.DefineAndReturnParticleTile(0, mfi);
+        auto ptd = ptile.getConstParticleTileData();
+        auto& soa = ptile.GetStructOfArrays();
+        for (int comp = 0; comp < tags.real.size(); ++comp) {
+            const int tag = tags.real[comp];
+            if (tag < 0) { continue; }
+            auto const* p = soa.GetRealData(comp).dataPtr();
+            reduce_op.eval(ptile.numParticles(), reduce_data,
+            [=] AMREX_GPU_DEVICE (int i) -> GpuTuple<Long>
+            {
+                return { Long(p[i] != real_value(ptd.id(i), tag)) };
+            });
+        }
+        for (int comp = 0; comp < tags.integer.size(); ++comp) {
+            const int tag = tags.integer[comp];
+            if (tag < 0) { continue; }
+            auto const* p = soa.GetIntData(comp).dataPtr();
+            reduce_op.eval(ptile.numParticles(), reduce_data,
+            [=] AMREX_GPU_DEVICE (int i) -> GpuTuple<Long>
+            {
+                return { Long(p[i] != int_value(ptd.id(i), tag)) };
+            });
+        }
+    }
+    Long nwrong = amrex::get<0>(reduce_data.value(reduce_op));
+    ParallelDescriptor::ReduceLongSum(nwrong);
+    return nwrong;
+}
+
+// Moves the particles by half the domain in the first direction, which is
+// periodic, so that most of them change grid.
+void move_particles (PC& pc)
+{
+    const auto& geom = pc.Geom(0);
+    const Real plo = geom.ProbLo(0);
+    const Real len = geom.ProbLength(0);
+    for (MFIter mfi = pc.MakeMFIter(0); mfi.isValid(); ++mfi) {
+        auto& ptile = pc.DefineAndReturnParticleTile(0, mfi);
+        auto ptd = ptile.getParticleTileData();
+        amrex::ParallelFor(ptile.numParticles(), [=] AMREX_GPU_DEVICE (int i) noexcept
+        {
+            ParticleReal x = ptd.pos(0, i) + ParticleReal(0.5)*len;
+            if (x >= plo + len) { x -= len; }
+            ptd.pos(0, i) = x;
+        });
+    }
+    Gpu::streamSynchronize();
+}
+
+void testRuntimeComps (TestParams const& params)
+{
+    RealBox real_box;
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+        real_box.setLo(d, 0.0);
+        real_box.setHi(d, 1.0);
+    }
+    const Box domain(IntVect(0), IntVect(params.size - 1));
+    Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(1,1,1)};
+    Geometry geom(domain, real_box, CoordSys::cartesian, is_periodic);
+
+    BoxArray ba(domain);
+    ba.maxSize(params.max_grid_size);
+    DistributionMapping dm(ba);
+
+    PC pc(geom, dm, ba);
+    for (int i = 0; i < 3; ++i) { pc.AddRealComp(true); }
+    for (int i = 0; i < 2; ++i) { pc.AddIntComp(true); }
+
+    CompTags tags{{0, 1, 2, 3, 4}, {0, 1, 2}};
+    init_particles(pc, params.num_ppc, tags);
+    pc.Redistribute();
+    const Long np = pc.TotalNumberOfParticles();
+    AMREX_ALWAYS_ASSERT(count_wrong(pc, tags) == 0);
+
+    // Remove a runtime Real component in the middle and the first runtime
+    // Int component.
+    pc.RemoveRealComp(NAR+1);
+    pc.RemoveIntComp(NAI);
+    tags.real.erase(tags.real.begin() + NAR+1);
+    tags.integer.erase(tags.integer.begin() + NAI);
+    AMREX_ALWAYS_ASSERT(pc.NumRuntimeRealComps() == 2 && pc.NumRuntimeIntComps() == 1);
+    Long nwrong = count_wrong(pc, tags);
+    amrex::Print() << "After removal: " << nwrong << " wrong values\n";
+    AMREX_ALWAYS_ASSERT(nwrong == 0);
+
+    const int rtrans = pc.AddTransientRealComp();
+    const int itrans = pc.AddTransientIntComp();
+    AMREX_ALWAYS_ASSERT(rtrans == NAR+2 && itrans == NAI+1);
+    AMREX_ALWAYS_ASSERT(pc.isTransientRealComp(rtrans) && pc.isTransientIntComp(itrans));
+    for (int comp = 0; comp < rtrans; ++comp) {
+        AMREX_ALWAYS_ASSERT(!pc.isTransientRealComp(comp));
+    }
+    for (int comp = 0; comp < itrans; ++comp) {
+        AMREX_ALWAYS_ASSERT(!pc.isTransientIntComp(comp));
+    }
+    fill_transient(pc, rtrans, itrans, 7, 8);
+    tags.real.push_back(7);
+    tags.integer.push_back(8);
+    AMREX_ALWAYS_ASSERT(count_wrong(pc, tags) == 0);
+
+    // The transient components are not communicated, so their values are
+    // not checked after the particles move.
+    move_particles(pc);
+    pc.Redistribute();
+    tags.real.back() = -1;
+    tags.integer.back() = -1;
+    nwrong = count_wrong(pc, tags);
+    amrex::Print() << "After Redistribute: " << pc.TotalNumberOfParticles() << " of " << np
+                   << " particles, " << nwrong << " wrong values\n";
+    AMREX_ALWAYS_ASSERT(pc.TotalNumberOfParticles() == np && nwrong == 0);
+
+    // The checkpoint has only the runtime components that are not
+    // transient, so Restart would abort if the transient ones were written.
+    pc.Checkpoint("runtime_comps_chk", "particle0");
+    {
+        PC pc_restart(geom, dm, ba);
+        for (int i = 0; i < 2; ++i) { pc_restart.AddRealComp(true); }
+        pc_restart.AddIntComp(true);
+        pc_restart.Restart("runtime_comps_chk", "particle0");
+        CompTags restart_tags{{tags.real.begin(), tags.real.end()-1},
+                              {tags.integer.begin(), tags.integer.end()-1}};
+        nwrong = count_wrong(pc_restart, restart_tags);
+        amrex::Print() << "After Restart: " << pc_restart.TotalNumberOfParticles() << " of " << np
+                       << " particles, " << nwrong << " wrong values\n";
+        AMREX_ALWAYS_ASSERT(pc_restart.TotalNumberOfParticles() == np && nwrong == 0);
+    }
+
+    pc.RemoveRealComp(rtrans);
+    pc.RemoveIntComp(itrans);
+    tags.real.pop_back();
+    tags.integer.pop_back();
+    AMREX_ALWAYS_ASSERT(pc.NumRuntimeRealComps() == 2 && pc.NumRuntimeIntComps() == 1);
+
+    move_particles(pc);
+    pc.Redistribute();
+    nwrong = count_wrong(pc, tags);
+    amrex::Print() << "Without the transient components: " << pc.TotalNumberOfParticles()
+                   << " of " << np << " particles, " << nwrong << " wrong values\n";
+    AMREX_ALWAYS_ASSERT(pc.TotalNumberOfParticles() == np && nwrong == 0);
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        TestParams params;
+        get_test_params(params, "rt");
+        testRuntimeComps(params);
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,179 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Particles.H>
+#include <AMReX_ParticleTreeGravity.H>
+
+#include <algorithm>
+#include <random>
+
+using namespace amrex;
+
+// Real components: the mass, the acceleration and the potential
+using PC = ParticleContainer<0, 0, AMREX_SPACEDIM+2, 0>;
+using PType = PC::ParticleType;
+
+constexpr int mass_comp = 0;
+constexpr int accel_comp = 1;
+constexpr int phi_comp = AMREX_SPACEDIM+1;
+
+struct TestParams
+{
+    IntVect size;
+    int max_grid_size;
+    int num_particles;
+    Real softening;
+    Real theta;
+    Real tolerance;
+};
+
+void get_test_params (TestParams& params, const std::string& prefix)
+{
+    ParmParse pp(prefix);
+    pp.get("size", params.size);
+    pp.get("max_grid_size", params.max_grid_size);
+    pp.get("num_particles", params.num_particles);
+    pp.get("softening", params.softening);
+    pp.get("theta", params.theta);
+    pp.get("tolerance", params.tolerance);
+}
+
+// The same sources on every process: half of them uniform in the unit
+// cube, and half in a clump, so that the tree is not uniform.
+void make_sources (int n, Vector<RealVect>& pos, Vector<Real>& mass)
+{
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<Real> uniform(Real(0.), Real(1.));
+    std::normal_distribution<Real> normal(Real(0.), Real(0.05));
+    pos.resize(n);
+    mass.resize(n);
+    for (int i = 0; i < n; ++i) {
+        for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+            if (i % 2 == 0) {
+                pos[i][d] = uniform(gen);
+            } else {
+                pos[i][d] = std::clamp(Real(0.3) + normal(gen), Real(0.01), Real(0.99));
+            }
+        }
+        mass[i] = Real(0.5) + uniform(gen);
+    }
+}
+
+void direct_sum (RealVect const& x, Vector<RealVect> const& pos, Vector<Real> const& mass,
+                 Real eps, Real& phi, RealVect& acc)
+{
+    phi = 0;
+    acc = RealVect(Real(0));
+    for (int j = 0; j < static_cast<int>(pos.size()); ++j) {
+        RealVect dx = x - pos[j];
+        Real r2 = dx.radSquared() + eps*eps;
+        if (r2 == Real(0)) { continue; }
+        Real rinv = Real(1.)/std::sqrt(r2);
+        phi -= mass[j]*rinv;
+        acc -= (mass[j]*rinv*rinv*rinv)*dx;
+    }
+}
+
+// Returns the maximum errors of the acceleration and of the potential,
+// relative to the maximum magnitudes of the direct sums.
+std::pair<Real,Real> check (PC& pc, Vector<RealVect> const& pos, Vector<Real> const& mass,
+                            Real eps, Real theta)
+{
+    ParticleTreeGravity tree;
+    tree.setOpeningAngle(theta);
+    tree.setSoftening(eps);
+    tree.build(pc, mass_comp);
+    tree.computeAccelerations(pc, accel_comp, phi_comp);
+
+    Real acc_err = 0, acc_max = 0, phi_err = 0, phi_max = 0;
+    for (int lev = 0; lev <= pc.finestLevel(); ++lev) {
+        for (PC::ParIterType pti(pc, lev); pti.isValid(); ++pti) {
+            auto const& ptile = pti.GetParticleTile();
+            auto const& aos = ptile.GetArrayOfStructs();
+            auto const& soa = ptile.GetStructOfArrays();
+            for (int i = 0; i < pti.numParticles(); ++i) {
+                RealVect x(AMREX_D_DECL(aos[i].pos(0), aos[i].pos(1), aos[i].pos(2)));
+                Real phi;
+                RealVect acc;
+                direct_sum(x, pos, mass, eps, phi, acc);
+                RealVect acc_tree;
+                for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                    acc_tree[d] = soa.GetRealData(accel_comp+d)[i];
+                }
+                acc_err = std::max(acc_err, (acc_tree-acc).vectorLength());
+                acc_max = std::max(acc_max, acc.vectorLength());
+                phi_err = std::max(phi_err, std::abs(soa.GetRealData(phi_comp)[i]-phi));
+                phi_max = std::max(phi_max, std::abs(phi));
+            }
+        }
+    }
+    ParallelDescriptor::ReduceRealMax({acc_err, acc_max, phi_err, phi_max});
+    return {acc_err/acc_max, phi_err/phi_max};
+}
+
+void testTreeGravity (TestParams const& params)
+{
+    RealBox real_box;
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+        real_box.setLo(d, 0.0);
+        real_box.setHi(d, 1.0);
+    }
+
+    const Box domain(IntVect(0), params.size - 1);
+    Geometry geom(domain, &real_box);
+
+    BoxArray ba(domain);
+    ba.maxSize(params.max_grid_size);
+    DistributionMapping dm(ba);
+
+    PC pc(geom, dm, ba);
+
+    Vector<RealVect> pos;
+    Vector<Real> mass;
+    make_sources(params.num_particles, pos, mass);
+
+    // Each process adds its share to its first box, and Redistribute moves
+    // the particles to where they belong.
+    const int nprocs = ParallelDescriptor::NProcs();
+    const int myproc = ParallelDescriptor::MyProc();
+    for (MFIter mfi = pc.MakeMFIter(0); mfi.isValid(); ++mfi) {
+        auto& ptile = pc.DefineAndReturnParticleTile(0, mfi.index(), mfi.LocalTileIndex());
+        for (int i = myproc; i < params.num_particles; i += nprocs) {
+            PType p;
+            p.id() = i+1;
+            p.cpu() = myproc;
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) { p.pos(d) = pos[i][d]; }
+            ptile.push_back(p);
+            ptile.push_back_real(mass_comp, mass[i]);
+            for (int comp = 1; comp < PC::NArrayReal; ++comp) {
+                ptile.push_back_real(comp, ParticleReal(0.));
+            }
+        }
+        break;
+    }
+    pc.Redistribute();
+    AMREX_ALWAYS_ASSERT(pc.TotalNumberOfParticles() == params.num_particles);
+
+    // With theta = 0, no node is accepted, so the sum is direct.
+    auto [acc_err0, phi_err0] = check(pc, pos, mass, params.softening, Real(0.));
+    amrex::Print() << "theta = 0: relative errors " << acc_err0 << " (acceleration), "
+                   << phi_err0 << " (potential)\n";
+    AMREX_ALWAYS_ASSERT(acc_err0 < Real(1.e-12) && phi_err0 < Real(1.e-12));
+
+    auto [acc_err, phi_err] = check(pc, pos, mass, params.softening, params.theta);
+    amrex::Print() << "theta = " << params.theta << ": relative errors " << acc_err
+                   << " (acceleration), " << phi_err << " (potential)\n";
+    AMREX_ALWAYS_ASSERT(acc_err < params.tolerance && phi_err < params.tolerance);
+    AMREX_ALWAYS_ASSERT(acc_err > acc_err0);
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        TestParams params;
+        get_test_params(params, "tree");
+
+        testTreeGravity(params);
+    }
+    amrex::Finalize();
+}
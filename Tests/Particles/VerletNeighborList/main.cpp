@@ -0,0 +1,269 @@
+//
+// Benchmark of Verlet neighbor lists: a soft-sphere system is advanced for
+// a number of steps once with the neighbor list rebuilt every step (skin = 0)
+// and once with a skin, where the list is only rebuilt when some particle
+// has moved more than half the skin.  Reports steps per second and checks
+// that both runs give the same kinetic energy.
+//
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_NeighborParticles.H>
+
+#include <cmath>
+
+using namespace amrex;
+
+struct TestParams
+{
+    IntVect size;
+    int max_grid_size;
+    int is_periodic;
+    int nsteps = 200;
+    Real dt = 0.01;
+    Real cutoff = 0.5;
+    Real skin = 0.3;
+    Real vel_std = 0.5;
+};
+
+struct PIdx
+{
+    enum {
+        AMREX_D_DECL(vx = 0, vy, vz),
+        AMREX_D_DECL(ax, ay, az),
+        ncomps
+    };
+};
+
+struct CheckPair
+{
+    Real m_radius2;
+
+    template <class P>
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    bool operator() (const P& p1, const P& p2) const
+    {
+        AMREX_D_TERM(Real d0 = (p1.pos(0) - p2.pos(0));,
+                     Real d1 = (p1.pos(1) - p2.pos(1));,
+                     Real d2 = (p1.pos(2) - p2.pos(2));)
+        Real dsquared = AMREX_D_TERM(d0*d0, + d1*d1, + d2*d2);
+        return (dsquared <= m_radius2);
+    }
+};
+
+class SoftSphereContainer
+    : public NeighborParticleContainer<PIdx::ncomps, 0>
+{
+public:
+
+    SoftSphereContainer (const Geometry& geom, const DistributionMapping& dm,
+                         const BoxArray& ba, int ncells)
+        : NeighborParticleContainer<PIdx::ncomps, 0>(geom, dm, ba, ncells)
+    {}
+
+    void InitParticles (Real vel_std)
+    {
+        const int lev = 0;
+        const auto dx = Geom(lev).CellSizeArray();
+        const auto plo = Geom(lev).ProbLoArray();
+
+        for (MFIter mfi = MakeMFIter(lev); mfi.isValid(); ++mfi)
+        {
+            const Box& tile_box = mfi.tilebox();
+            Gpu::HostVector<ParticleType> host_particles;
+            for (IntVect iv = tile_box.smallEnd(); iv <= tile_box.bigEnd(); tile_box.next(iv)) {
+                ParticleType p;
+                p.id()  = ParticleType::NextID();
+                p.cpu() = ParallelDescriptor::MyProc();
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    p.pos(idim) = static_cast<ParticleReal>
+                        (plo[idim] + (iv[idim] + Real(0.2) + Real(0.6)*amrex::Random())*dx[idim]);
+                    p.rdata(PIdx::vx+idim) = static_cast<ParticleReal>(amrex::RandomNormal(0.0, vel_std));
+                    p.rdata(PIdx::ax+idim) = 0.0;
+                }
+                host_particles.push_back(p);
+            }
+
+            auto& ptile = DefineAndReturnParticleTile(lev, mfi.index(), mfi.LocalTileIndex());
+            auto old_size = ptile.GetArrayOfStructs().size();
+            auto new_size = old_size + host_particles.size();
+            ptile.resize(new_size);
+            Gpu::copy(Gpu::hostToDevice, host_particles.begin(), host_particles.end(),
+                      ptile.GetArrayOfStructs().begin() + old_size);
+        }
+
+        Redistribute();
+    }
+
+    // Linear repulsion between particles closer than the cutoff
+    void computeForces (Real cutoff)
+    {
+        BL_PROFILE("SoftSphereContainer::computeForces");
+
+        const int lev = 0;
+        auto& plev = GetParticles(lev);
+
+        for (MyParIter pti(*this, lev); pti.isValid(); ++pti)
+        {
+            auto index = std::make_pair(pti.index(), pti.LocalTileIndex());
+            auto& aos = plev[index].GetArrayOfStructs();
+            const int np = aos.numParticles();
+            ParticleType* pstruct = aos().dataPtr();
+            auto nbor_data = m_neighbor_list[lev][index].data();
+
+            amrex::ParallelFor(np, [=] AMREX_GPU_DEVICE (int i) noexcept
+            {
+                ParticleType& p1 = pstruct[i];
+                Real acc[AMREX_SPACEDIM] = {AMREX_D_DECL(0.,0.,0.)};
+                for (const auto& p2 : nbor_data.getNeighbors(i))
+                {
+                    Real d[AMREX_SPACEDIM];
+                    Real r2 = 0.;
+                    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                        d[idim] = p1.pos(idim) - p2.pos(idim);
+                        r2 += d[idim]*d[idim];
+                    }
+                    if (r2 < cutoff*cutoff) {
+                        Real r = std::sqrt(r2);
+                        Real coef = (cutoff - r) / amrex::max(r, Real(1.e-6));
+                        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                            acc[idim] += coef*d[idim];
+                        }
+                    }
+                }
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    p1.rdata(PIdx::ax+idim) = static_cast<ParticleReal>(acc[idim]);
+                }
+            });
+        }
+    }
+
+    void moveParticles (Real dt)
+    {
+        BL_PROFILE("SoftSphereContainer::moveParticles");
+
+        const int lev = 0;
+        for (MyParIter pti(*this, lev); pti.isValid(); ++pti)
+        {
+            auto& aos = pti.GetArrayOfStructs();
+            const int np = aos.numParticles();
+            ParticleType* pstruct = aos().dataPtr();
+            amrex::ParallelFor(np, [=] AMREX_GPU_DEVICE (int i) noexcept
+            {
+                ParticleType& p = pstruct[i];
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    p.rdata(PIdx::vx+idim) += static_cast<ParticleReal>(dt*p.rdata(PIdx::ax+idim));
+                    p.pos(idim) += static_cast<ParticleReal>(dt*p.rdata(PIdx::vx+idim));
+                }
+            });
+        }
+    }
+
+    Real kineticEnergy ()
+    {
+        using PType = ParticleType;
+        Real ke = amrex::ReduceSum(*this, [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
+        {
+            return Real(0.5)*(AMREX_D_TERM(p.rdata(PIdx::vx)*p.rdata(PIdx::vx),
+                                          + p.rdata(PIdx::vy)*p.rdata(PIdx::vy),
+                                          + p.rdata(PIdx::vz)*p.rdata(PIdx::vz)));
+        });
+        ParallelDescriptor::ReduceRealSum(ke);
+        return ke;
+    }
+
+    using MyParIter = ParIter<PIdx::ncomps, 0>;
+};
+
+void get_test_params (TestParams& params, const std::string& prefix)
+{
+    ParmParse pp(prefix);
+    pp.get("size", params.size);
+    pp.get("max_grid_size", params.max_grid_size);
+    pp.get("is_periodic", params.is_periodic);
+    pp.query("nsteps", params.nsteps);
+    pp.query("dt", params.dt);
+    pp.query("cutoff", params.cutoff);
+    pp.query("skin", params.skin);
+    pp.query("vel_std", params.vel_std);
+}
+
+// Returns steps per second
+Real run (TestParams const& params, Real skin, Real& ke, Long& nbuilds)
+{
+    RealBox real_box;
+    for (int n = 0; n < AMREX_SPACEDIM; n++)
+    {
+        real_box.setLo(n, 0.0);
+        real_box.setHi(n, params.size[n]);
+    }
+
+    IntVect domain_lo(AMREX_D_DECL(0, 0, 0));
+    IntVect domain_hi(AMREX_D_DECL(params.size[0]-1,params.size[1]-1,params.size[2]-1));
+    const Box domain(domain_lo, domain_hi);
+
+    int coord = 0;
+    int is_per[] = {AMREX_D_DECL(params.is_periodic,
+                                 params.is_periodic,
+                                 params.is_periodic)};
+    Geometry geom(domain, &real_box, coord, is_per);
+
+    BoxArray ba(domain);
+    ba.maxSize(params.max_grid_size);
+    DistributionMapping dm(ba);
+
+    // The cell size is one, so one neighbor cell covers cutoff + skin.
+    AMREX_ALWAYS_ASSERT(params.cutoff + skin <= Real(1.0));
+    const int ncells = 1;
+    SoftSphereContainer pc(geom, dm, ba, ncells);
+
+    amrex::ResetRandomSeed(ParallelDescriptor::MyProc()+1);
+    pc.InitParticles(params.vel_std);
+
+    pc.setVerletSkin(skin);
+    CheckPair check_pair{(params.cutoff+skin)*(params.cutoff+skin)};
+
+    ParallelDescriptor::Barrier();
+    Real t0 = amrex::second();
+
+    for (int step = 0; step < params.nsteps; ++step) {
+        pc.buildVerletNeighborList(check_pair);
+        pc.computeForces(params.cutoff);
+        pc.moveParticles(params.dt);
+    }
+    Gpu::streamSynchronize();
+
+    ParallelDescriptor::Barrier();
+    Real t1 = amrex::second();
+
+    pc.Redistribute();
+    ke = pc.kineticEnergy();
+    nbuilds = pc.numVerletBuilds();
+
+    return Real(params.nsteps) / (t1 - t0);
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        TestParams params;
+        get_test_params(params, "verlet");
+
+        Real ke_ref, ke_skin;
+        Long nbuilds_ref, nbuilds_skin;
+        Real rate_ref = run(params, Real(0.0), ke_ref, nbuilds_ref);
+        Real rate_skin = run(params, params.skin, ke_skin, nbuilds_skin);
+
+        amrex::Print() << "Without skin: " << rate_ref << " steps/sec, "
+                       << nbuilds_ref << " list builds\n"
+                       << "With skin " << params.skin << ": " << rate_skin << " steps/sec, "
+                       << nbuilds_skin << " list builds\n"
+                       << "Kinetic energy: " << ke_ref << " vs " << ke_skin << "\n";
+
+        AMREX_ALWAYS_ASSERT(nbuilds_ref == params.nsteps);
+        AMREX_ALWAYS_ASSERT(std::abs(ke_skin-ke_ref) <= Real(1.e-8)*ke_ref);
+    }
+    amrex::Finalize();
+}